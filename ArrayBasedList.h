@@ -3,19 +3,85 @@
     singly linked list using an array-based NodePool.
 
     Basic operations are:
-        Constructor: Constructs an empty list.
+        Constructor: Constructs an empty list, or a list holding the
+                     elements of an iterator range or initializer_list.
         isEmpty: Check if list is empty.
         insertAtPosition: Insert node with data in the list at specified
                           position.
+        insertRange: Insert the elements of an iterator range at a position.
+        appendRange: Insert the elements of an iterator range at the end.
         deleteAtPosition: Delete node at specified position.
         search: Search for specified data in the list.
+        searchMany: Search for many values in a single traversal.
         display: Print list content.
+        dump: Print a page of the list content through one buffered write.
         displayFreeNodes: Print free nodes' positions in the NodePool.
+        poolStats: Report occupancy and fragmentation of the NodePool.
+        shrinkPool: Free unused chunks of a growable NodePool.
         sort: Sorts the list in ascending order.
         size: Returns the size of the list.
+        removeIf: Remove every element satisfying a predicate in one pass.
+        removeAll: Remove every occurrence of a value in one pass.
+        parallelForEach: Call a function on every element, on several threads.
+        parallelTransform: Replace every element in place, on several threads.
+        parallelReduce: Fold the elements in order, on several threads.
+        erase: Remove the elements of an iterator range.
+        splitAt: Detach the elements from a position on as a Segment.
+        extract: Detach the elements of an iterator range as a Segment.
+        splice: Link a Segment back into the list at a position.
+        merge: Merge a sorted Segment into the sorted list.
+        release: Give the nodes of a Segment back to the NodePool.
+        clear: Remove every element from the list.
+        save: Write the list to a binary snapshot.
+        load: Rebuild the list from a binary snapshot.
+        stats: Get the statistics of the instrumentation policy.
+        resetStats: Reset the statistics of the instrumentation policy.
+
+    const_iterator (nested class) walks the list in order, read-only, so the
+    list can be used with range-based for loops and standard algorithms.
+
+    Appender (nested class) adds elements at the end of a list in O(1) each,
+    after a single walk to the end when it is created.
+
+    Segment (nested class) is a chain of nodes detached from the list but
+    still in its NodePool, so sub-sequences can be split off, merged and
+    spliced back by rewiring 'next' indices only: no element is copied and
+    no node is acquired or released. Segments count as used nodes, and
+    clear() or load() reclaims them.
+
+    Snapshot format (host byte order):
+        magic:       8 bytes  ("ABLSNAP" followed by a zero byte)
+        version:     uint32
+        elementSize: uint32   (sizeof(ElementType) for trivially copyable
+                               types, 0 for types with a custom encoding)
+        count:       uint64   (number of elements)
+        elements:    count encoded elements, in logical order
+        checksum:    uint64   (FNV-1a of the encoded elements)
+
+    Trivially copyable elements are encoded as their raw bytes and copied in
+    large blocks; std::string is encoded as a uint32 length and its bytes.
+
+    Capacity is a template parameter (default CAPACITY) giving the number of
+    nodes in the list's NodePool. Instrumentation is a template parameter
+    (default NoInstrumentation, which compiles to nothing) choosing the
+    statistics gathered; see ListInstrumentation.h. Eviction is a template
+    parameter (default EvictFirst) choosing the element a forced insert
+    evicts when the NodePool is full; see ListEviction.h.
+
+    With Capacity == GROWABLE the list uses a growable NodePool (see
+    NodePool.h): it is never full, and its nodes are allocated in chunks as
+    it grows. shrinkPool() gives back the chunks no longer needed, and a
+    pmr::memory_resource given to the constructor supplies them. Such a
+    list owns heap memory, so it can not be used by PersistentList or
+    SharedList, nor with the EvictTail and EvictClock policies (their
+    per-node state is sized by Capacity).
+
+    The parallel algorithms cut the chain into balanced chunks with one walk
+    and run them on a work-stealing set of threads (see ListParallel.h);
+    programs using them must be linked with -pthread.
 
     Class Invariant:
-        1. The list elements are stored in positions 0, 1,..., CAPACITY - 1
+        1. The list elements are stored in positions 0, 1,..., Capacity - 1
         2. first stores the index of the first node in the list, or NULL_INDEX
            if list is empty.
         3. All used nodes are linked together through their 'next' data field,
@@ -25,15 +91,170 @@
 #ifndef ARRAYBASEDLIST_H
 #define ARRAYBASEDLIST_H
 
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
 #include <iostream>
+#include <iterator>
+#include <locale>
+#include <memory_resource>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "ListEviction.h"
+#include "ListInstrumentation.h"
+#include "ListParallel.h"
 #include "NodePool.h"
 
 using namespace std;
 
-template <typename ElementType>
+const char SNAPSHOT_MAGIC[8] = {'A', 'B', 'L', 'S', 'N', 'A', 'P', '\0'};
+const uint32_t SNAPSHOT_VERSION = 1;
+const size_t SNAPSHOT_BLOCK = 64 * 1024; // bytes buffered per read/write
+const size_t DUMP_BLOCK = 64 * 1024;     // bytes formatted per dump write
+
+template <typename ElementType, int Capacity = CAPACITY,
+          typename Instrumentation = NoInstrumentation,
+          typename Eviction = EvictFirst>
 class ArrayBasedList
 {
 public:
+    /** Public class Appender */
+    class Appender
+    {
+    public:
+        /******** Member Functions ********/
+
+        /***** Class constructor *****/
+        explicit Appender(ArrayBasedList &list);
+        /*----------------------------------------------------------------------
+            Construct an Appender for a list.
+
+            Precondition:  None.
+            Postcondition: The Appender remembers the last node of 'list'
+                           (found with one walk from first).
+        ----------------------------------------------------------------------*/
+
+        bool append(const ElementType &value);
+        /*----------------------------------------------------------------------
+            Add an element at the end of the list.
+
+            Precondition:  The last node of the list was not changed, other
+                           than by this Appender, since the Appender was
+                           constructed (changes before it are fine).
+            Postcondition: 'value' is linked after the last node in O(1) and
+                           true is returned; false if the NodePool is full.
+        ----------------------------------------------------------------------*/
+
+    private:
+        /******** Data members ********/
+        ArrayBasedList &list; // list being extended
+        int last;             // index of the last node, or NULL_INDEX
+    };
+
+    /** Public class const_iterator */
+    class const_iterator
+    {
+    public:
+        typedef forward_iterator_tag iterator_category;
+        typedef ElementType value_type;
+        typedef ptrdiff_t difference_type;
+        typedef const ElementType *pointer;
+        typedef const ElementType &reference;
+
+        /******** Member Functions ********/
+
+        /***** Class constructor *****/
+        const_iterator();
+        /*----------------------------------------------------------------------
+            Construct an iterator equal to end() of any list.
+
+            Precondition:  None.
+            Postcondition: The iterator refers to no node.
+        ----------------------------------------------------------------------*/
+
+        reference operator*() const;
+        pointer operator->() const;
+        /*----------------------------------------------------------------------
+            Access the element the iterator refers to.
+
+            Precondition:  The iterator is not end().
+            Postcondition: Returns the element stored in the current node.
+        ----------------------------------------------------------------------*/
+
+        const_iterator &operator++();
+        const_iterator operator++(int);
+        /*----------------------------------------------------------------------
+            Move to the next element.
+
+            Precondition:  The iterator is not end().
+            Postcondition: The iterator refers to the next node, or is end()
+                           if it was at the last node.
+        ----------------------------------------------------------------------*/
+
+        bool operator==(const const_iterator &other) const;
+        bool operator!=(const const_iterator &other) const;
+        /*----------------------------------------------------------------------
+            Compare two iterators.
+
+            Precondition:  Both iterators belong to the same list.
+            Postcondition: Returns whether they refer to the same node.
+        ----------------------------------------------------------------------*/
+
+        int nodeIndex() const;
+        /*----------------------------------------------------------------------
+            Index of the current node in the NodePool.
+
+            Precondition:  None.
+            Postcondition: Returns the index, or NULL_INDEX for end().
+        ----------------------------------------------------------------------*/
+
+    private:
+        friend class ArrayBasedList;
+        const_iterator(const NodePool<ElementType, Capacity> *pool, int index);
+
+        /******** Data members ********/
+        const NodePool<ElementType, Capacity> *pool; // pool of the list
+        int index;                                    // current node
+    };
+
+    /** Public class Segment */
+    class Segment
+    {
+    public:
+        /******** Member Functions ********/
+
+        /***** Class constructor *****/
+        Segment();
+        /*----------------------------------------------------------------------
+            Construct an empty Segment.
+
+            Precondition:  None.
+            Postcondition: The Segment holds no node.
+        ----------------------------------------------------------------------*/
+
+        bool isEmpty() const;
+        int size() const;
+        /*----------------------------------------------------------------------
+            Check if the Segment is empty / get its number of elements.
+
+            Precondition:  None.
+            Postcondition: Returns whether it holds no node / how many.
+        ----------------------------------------------------------------------*/
+
+    private:
+        friend class ArrayBasedList;
+
+        /******** Data members ********/
+        int head;   // first node, or NULL_INDEX
+        int tail;   // last node (its next is NULL_INDEX), or NULL_INDEX
+        int length; // number of nodes
+    };
+
     /******** Member Functions ********/
 
     /***** Class constructor *****/
@@ -47,7 +268,46 @@ public:
                        default NodePool.
     --------------------------------------------------------------------------*/
 
-    // ~ArrayBasedList(); // not needed (same for copy-constructor and assignement operator)
+    template <typename ForwardIterator>
+    ArrayBasedList(ForwardIterator rangeBegin, ForwardIterator rangeEnd);
+    ArrayBasedList(initializer_list<ElementType> values);
+    /*--------------------------------------------------------------------------
+        Construct an ArrayBasedList holding a sequence of elements.
+
+        Precondition:  The sequence has at most Capacity elements.
+        Postcondition: The list holds the elements in order, in nodes
+                       acquired as one chain (physically contiguous); extra
+                       elements beyond Capacity are dropped.
+    --------------------------------------------------------------------------*/
+
+    explicit ArrayBasedList(pmr::memory_resource *resource);
+    /*--------------------------------------------------------------------------
+        Construct an empty ArrayBasedList whose growable NodePool takes its
+        memory from 'resource'.
+
+        Precondition:  Capacity == GROWABLE; 'resource' outlives the list.
+        Postcondition: An empty list is constructed; every chunk of nodes
+                       will be allocated from 'resource'.
+    --------------------------------------------------------------------------*/
+
+    // ~ArrayBasedList(); // not needed
+
+    ArrayBasedList(const ArrayBasedList &other) = default;
+    ArrayBasedList &operator=(const ArrayBasedList &other) = default;
+    ArrayBasedList(ArrayBasedList &&other)
+        noexcept(is_nothrow_move_constructible<NodePool<ElementType, Capacity>>::value);
+    ArrayBasedList &operator=(ArrayBasedList &&other);
+    /*--------------------------------------------------------------------------
+        Copy or move a list.
+
+        Precondition:  None.
+        Postcondition: This list holds the elements of 'other' in the same
+                       nodes. A copy of a growable list throws bad_alloc if
+                       its chunks can not be allocated, and an assigned list
+                       is then unchanged. A move takes the chunks of a
+                       growable pool without copying them and leaves 'other'
+                       empty.
+    --------------------------------------------------------------------------*/
 
     bool isEmpty() const;
     /*----------------------------------------------------------------------
@@ -63,7 +323,7 @@ public:
         Insert a new element at a specified position in the list.
 
         Precondition:
-            position is an integer between 0 and CAPACITY - 1.
+            position is an integer between 0 and Capacity - 1.
             There is at least one free node in the NodePool.
 
         Postcondition:
@@ -72,20 +332,54 @@ public:
             If the list is full and insertion is not forced, insertion does not
                 happen and returns false.
             If the list is full and insertion is forced, insertion removes the
-                first element in the list and then inserts the element and
-                returns true.
+                element chosen by the Eviction policy (the first one by
+                default) and then inserts the element at 'position' and
+                returns true; it returns false if the policy chooses none.
 
         Notes:
             Position 0 inserts at the beginning.
             If the list is empty, only position 0 is valid.
 ------------------------------------------------------------------------------*/
 
+    template <typename ForwardIterator>
+    int insertRange(int position, ForwardIterator rangeBegin,
+                    ForwardIterator rangeEnd, bool forced = false);
+    /*--------------------------------------------------------------------------
+        Insert the elements of a range, in order, at a specified position.
+
+        Precondition:  0 <= position <= size(); ForwardIterator is a forward
+                       (multi-pass) iterator over ElementType values.
+
+        Postcondition:
+            The elements are inserted one after another, the first one at
+            'position'. The list is walked once; the nodes that fit are
+            acquired from the NodePool as one chain, filled and spliced in
+            with two link changes. If the pool is too small and insertion is
+            not forced, only the leading elements that fit are inserted. If
+            it is forced, each remaining element evicts the element chosen
+            by the Eviction policy, as insertAtPosition does (if the victim
+            is the element inserted just before, the new one takes its
+            place). Returns the number of elements inserted, 0 if position
+            is invalid.
+------------------------------------------------------------------------------*/
+
+    template <typename ForwardIterator>
+    int appendRange(ForwardIterator rangeBegin, ForwardIterator rangeEnd,
+                    bool forced = false);
+    /*--------------------------------------------------------------------------
+        Insert the elements of a range, in order, at the end of the list.
+
+        Precondition:  Same as insertRange().
+        Postcondition: Same as insertRange() at position size(), with a
+                       single walk to the last node.
+------------------------------------------------------------------------------*/
+
     bool deleteAtPosition(int position);
     /*--------------------------------------------------------------------------
         Delete the element at the specified position in the list.
 
         Precondition:
-            position is an integer between 0 and CAPACITY - 1.
+            position is an integer between 0 and Capacity - 1.
             The list is not empty.
 
         Postcondition:
@@ -106,6 +400,22 @@ public:
             Returns NULL_INDEX if the value is not found.
 ------------------------------------------------------------------------------*/
 
+    int searchMany(const ElementType *keys, int keyCount, int *positions) const;
+    /*--------------------------------------------------------------------------
+        Search for the first occurrence of each of several values in one walk.
+
+        Precondition:  keys and positions point to keyCount elements;
+                       ElementType is comparable with the < operator.
+
+        Postcondition:
+            positions[k] is the logical position of the first node containing
+            keys[k], or NULL_INDEX if it is not found (the same as
+            search(keys[k])). Returns the number of keys found. The keys
+            are sorted once (into a buffer reused across calls) and each
+            visited node is probed by binary search; the walk stops as soon
+            as every key is found.
+------------------------------------------------------------------------------*/
+
     void display(ostream &out) const;
     /*--------------------------------------------------------------------------
         Display all elements in the list in order.
@@ -117,6 +427,40 @@ public:
             If the list is empty, outputs "List is empty".
 ------------------------------------------------------------------------------*/
 
+    const_iterator begin() const;
+    /*--------------------------------------------------------------------------
+        Get an iterator to the first element.
+
+        Precondition:  None.
+        Postcondition: Returns an iterator to the first element, or end() if
+                       the list is empty.
+------------------------------------------------------------------------------*/
+
+    const_iterator end() const;
+    /*--------------------------------------------------------------------------
+        Get the past-the-end iterator.
+
+        Precondition:  None.
+        Postcondition: Returns an iterator that refers to no node.
+------------------------------------------------------------------------------*/
+
+    int dump(ostream &out, int offset = 0, int limit = -1) const;
+    /*--------------------------------------------------------------------------
+        Display a page of the list through a reusable buffer.
+
+        Precondition:  offset >= 0.
+
+        Postcondition:
+            Outputs, in the same format as display(), the elements at logical
+            positions offset, offset + 1,... up to 'limit' of them (all of
+            them if limit is negative), formatted with the flags, precision
+            and locale of 'out'. Elements are formatted into a buffer reused
+            across calls (with to_chars for integers printed in plain
+            decimal) and written with one out.write() per DUMP_BLOCK bytes;
+            'out' is not flushed.
+            Returns the number of elements written.
+------------------------------------------------------------------------------*/
+
     void displayFreeNodes(ostream &out) const;
     /*--------------------------------------------------------------------------
         Display the indices of free nodes in the NodePool.
@@ -125,6 +469,27 @@ public:
         Postcondition: Outputs the list of free node indices managed by NodePool.
 ------------------------------------------------------------------------------*/
 
+    PoolStats poolStats() const;
+    /*--------------------------------------------------------------------------
+        Report the occupancy and fragmentation of the NodePool.
+
+        Precondition:  None
+        Postcondition: Returns NodePool::occupancy() for the list's chain
+                       (used/free counts, high-water mark, bytes per live
+                       element, free-run distribution and chain locality).
+                       Use PoolStats::writeJson() to export it.
+------------------------------------------------------------------------------*/
+
+    int shrinkPool();
+    /*--------------------------------------------------------------------------
+        Free the chunks at the end of a growable NodePool that hold no node
+        of the list (or of its Segments).
+
+        Precondition:  Capacity == GROWABLE.
+        Postcondition: Returns NodePool::shrink(), the number of nodes freed.
+                       Elements and indices are unchanged.
+------------------------------------------------------------------------------*/
+
     void sort();
     /*--------------------------------------------------------------------------
         Sorts the list in ascending order
@@ -141,6 +506,59 @@ public:
         Postcondition: List size is returned.
 ------------------------------------------------------------------------------*/
 
+    template <typename Function>
+    void parallelForEach(Function function, int threadCount = 0,
+                         int grain = PARALLEL_GRAIN) const;
+    /*--------------------------------------------------------------------------
+        Call a function on every element, on several threads.
+
+        Precondition:  function(const ElementType &) may be called from
+                       several threads at once; grain >= 1.
+
+        Postcondition:
+            The chain is cut into balanced chunks by one walk that marks
+            every grain-th node, and the chunks are run with runChunks() on
+            threadCount threads (0: one per hardware thread), with work
+            stealing. Each element is passed once, in no particular order
+            across chunks. A smaller grain balances costly functions on
+            short lists better.
+------------------------------------------------------------------------------*/
+
+    template <typename Function>
+    void parallelTransform(Function function, int threadCount = 0,
+                           int grain = PARALLEL_GRAIN);
+    /*--------------------------------------------------------------------------
+        Replace every element with the result of a function on it, on
+        several threads.
+
+        Precondition:  Same as parallelForEach(); function returns a value
+                       assignable to ElementType.
+        Postcondition: Every element e is replaced by function(e), assigned
+                       in place into its NodePool slot: no node is acquired
+                       or relinked and the order is unchanged.
+------------------------------------------------------------------------------*/
+
+    template <typename T, typename FoldOperation, typename CombineOperation>
+    T parallelReduce(T identity, FoldOperation fold, CombineOperation combine,
+                     int threadCount = 0, int grain = PARALLEL_GRAIN) const;
+    /*--------------------------------------------------------------------------
+        Reduce all elements to one value, on several threads.
+
+        Precondition:  fold(T, ElementType) and combine(T, T) return T and
+                       may be called from several threads at once; combine
+                       is associative (it need not be commutative), identity
+                       is its identity, and combine(a, fold(identity, e))
+                       equals fold(a, e).
+        Postcondition:
+            Each chunk is folded in order from identity on its own thread,
+            as fold(...fold(fold(identity, e0), e1)..., ek), and the chunk
+            results are combined in chain order starting from identity, so
+            the result equals the serial fold of every element. A count of
+            the elements above 5 is, for instance,
+            parallelReduce(0L, [](long n, int e) { return n + (e > 5); },
+                           plus<long>()).
+------------------------------------------------------------------------------*/
+
     bool insertAfterValue(const ElementType &value, const ElementType &target, bool forced);
     /*--------------------------------------------------------------------------
         Insert a new element after the first occurrence of a target.
@@ -152,8 +570,9 @@ public:
                  If the list is full and insertion is not forced, insertion does not
                   happen and returns false.
                  If the list is full and insertion is forced, insertion removes the
-                 first element in the list and then inserts the element and
-                 returns true.
+                 element chosen by the Eviction policy (the first one by
+                 default) and then inserts the element and returns true; if
+                 target itself is evicted, the new element takes its place.
 ------------------------------------------------------------------------------*/
 
     bool insertBeforeValue(const ElementType &value, const ElementType &target, bool forced);
@@ -167,8 +586,9 @@ public:
                      if the list is full and insertion is not forced, insertion does not
                      happen and returns false.
                      if the list is full and insertion is forced, insertion removes the
-                     first element in the list and then inserts the element and
-                     returns true.
+                     element chosen by the Eviction policy (the first one by
+                     default) and then inserts the element and returns true; if
+                     target itself is evicted, the new element takes its place.
     --------------------------------------------------------------------------*/
 
     bool deleteAfterValue(const ElementType &target);
@@ -195,29 +615,470 @@ public:
         Postcondition: The value is removed from the list.
 ------------------------------------------------------------------------------*/
 
+    template <typename Predicate>
+    int removeIf(Predicate predicate);
+    /*--------------------------------------------------------------------------
+        Remove every element for which a predicate returns true.
+
+        Precondition:  predicate(element) is callable and returns bool.
+
+        Postcondition:
+            The matching elements are unlinked in a single walk (one link
+            change per run of consecutive matches), in order, and given back
+            to the NodePool as one chain in O(1). The predicate is called
+            once per element. Returns the number of elements removed.
+------------------------------------------------------------------------------*/
+
+    int removeAll(const ElementType &value);
+    /*--------------------------------------------------------------------------
+        Remove every occurrence of a value.
+
+        Precondition:  None.
+        Postcondition: Same as removeIf() with a test for equality to 'value'.
+------------------------------------------------------------------------------*/
+
+    int erase(const_iterator rangeBegin, const_iterator rangeEnd);
+    /*--------------------------------------------------------------------------
+        Remove the elements of an iterator range.
+
+        Precondition:  [rangeBegin, rangeEnd) is a valid range of this list.
+        Postcondition: The elements of the range are removed with one link
+                       change and given back to the NodePool as one chain.
+                       Returns the number of elements removed.
+------------------------------------------------------------------------------*/
+
+    Segment splitAt(int position);
+    /*--------------------------------------------------------------------------
+        Detach the elements from a position to the end.
+
+        Precondition:  0 <= position <= size().
+        Postcondition: The list keeps its first 'position' elements and the
+                       others are returned, in order, as a Segment (empty if
+                       position is invalid), by changing one link.
+------------------------------------------------------------------------------*/
+
+    Segment extract(const_iterator rangeBegin, const_iterator rangeEnd);
+    /*--------------------------------------------------------------------------
+        Detach the elements of an iterator range.
+
+        Precondition:  [rangeBegin, rangeEnd) is a valid range of this list.
+        Postcondition: The elements of the range are returned, in order, as a
+                       Segment; the list keeps the others, linked around it.
+------------------------------------------------------------------------------*/
+
+    bool splice(int position, Segment &segment);
+    /*--------------------------------------------------------------------------
+        Link the elements of a Segment into the list at a position.
+
+        Precondition:  segment was detached from this list.
+        Postcondition: The segment's elements are in the list, in order, the
+                       first one at 'position', by changing two links; the
+                       segment is empty and true is returned. Returns false,
+                       changing nothing, if position is not in 0..size().
+------------------------------------------------------------------------------*/
+
+    void merge(Segment &sorted);
+    /*--------------------------------------------------------------------------
+        Merge a sorted Segment into the sorted list.
+
+        Precondition:  The list and segment are sorted in ascending order,
+                       segment was detached from this list, and elements are
+                       comparable with the > operator.
+        Postcondition: The list holds the elements of both, sorted; equal
+                       elements keep their order, the list's first (stable).
+                       Runs in one pass by relinking nodes; the segment is
+                       empty.
+------------------------------------------------------------------------------*/
+
+    void release(Segment &segment);
+    /*--------------------------------------------------------------------------
+        Give the nodes of a Segment back to the NodePool.
+
+        Precondition:  segment was detached from this list.
+        Postcondition: The segment's nodes are free (one O(1) splice onto
+                       the free list) and the segment is empty.
+------------------------------------------------------------------------------*/
+
+    void clear();
+    /*--------------------------------------------------------------------------
+        Remove every element from the list.
+
+        Precondition:  None.
+        Postcondition: The list is empty and the NodePool is reset, so that
+                       the next nodes acquired are physically contiguous.
+------------------------------------------------------------------------------*/
+
+    bool save(ostream &out) const;
+    /*--------------------------------------------------------------------------
+        Write the list to a binary snapshot.
+
+        Precondition:  ElementType is trivially copyable or std::string; out
+                       is opened in binary mode.
+        Postcondition: The snapshot (see format above) is written to out.
+                       Returns true on success, false if writing failed.
+------------------------------------------------------------------------------*/
+
+    bool load(istream &in);
+    /*--------------------------------------------------------------------------
+        Rebuild the list from a binary snapshot.
+
+        Precondition:  ElementType is trivially copyable or std::string; in
+                       is opened in binary mode.
+        Postcondition: The list holds the snapshot's elements in order, stored
+                       as one physically contiguous chain built in a single
+                       pass. Returns true on success. Returns false, leaving
+                       the list empty, if the snapshot is truncated, fails its
+                       checksum, was written for another element type, has
+                       more than Capacity elements, or a growable pool can
+                       not get memory for them.
+------------------------------------------------------------------------------*/
+
+    ListStats stats() const;
+    /*--------------------------------------------------------------------------
+        Get the statistics gathered by the instrumentation policy.
+
+        Precondition:  None.
+        Postcondition: Returns a snapshot of the statistics (all zeros with
+                       NoInstrumentation).
+------------------------------------------------------------------------------*/
+
+    void resetStats();
+    /*--------------------------------------------------------------------------
+        Set every statistic of the instrumentation policy to zero.
+
+        Precondition:  None.
+        Postcondition: The next stats() only covers later calls.
+------------------------------------------------------------------------------*/
+
 private:
-    NodePool<ElementType> nodePool; // NodePool object to store data
-    int first;                      // first element in the list
+    int acquireNode();
+    /*--------------------------------------------------------------------------
+        Acquire a node from the NodePool, counting the call.
+
+        Precondition:  None.
+        Postcondition: Same as NodePool::acquireNode().
+------------------------------------------------------------------------------*/
+
+    void releaseNode(int index);
+    /*--------------------------------------------------------------------------
+        Release a node to the NodePool, counting the call.
+
+        Precondition:  0 <= index < Capacity.
+        Postcondition: Same as NodePool::releaseNode().
+------------------------------------------------------------------------------*/
+
+    void link(int node, int next);
+    void setFirst(int node);
+    /*--------------------------------------------------------------------------
+        Change the next field of a node, or first, telling the eviction
+        policy.
+
+        Precondition:  0 <= node < Capacity (or NULL_INDEX for setFirst);
+                       0 <= next < Capacity or next == NULL_INDEX.
+        Postcondition: Same as NodePool::setNextOfNode() / first = node.
+------------------------------------------------------------------------------*/
+
+    template <typename ForwardIterator>
+    int insertChain(int anchor, ForwardIterator rangeBegin,
+                    ForwardIterator rangeEnd, bool forced);
+    /*--------------------------------------------------------------------------
+        Insert the elements of a range after a node (insertRange() once the
+        insertion point is known).
+
+        Precondition:  anchor is a node of the list, or NULL_INDEX to insert
+                       at the beginning.
+        Postcondition: Same as insertRange().
+------------------------------------------------------------------------------*/
+
+    int evict(int victim, int &anchor);
+    /*--------------------------------------------------------------------------
+        Unlink the victim chosen by the eviction policy: O(1), or O(n) for
+        the last node when the policy does not know its predecessor.
+
+        Precondition:  victim is a node of the list and anchor is another
+                       node of the list, or NULL_INDEX.
+        Postcondition: The victim's element is removed from the list and the
+                       index of a node no longer in the list is returned, to
+                       be reused by the caller. When the victim is not the
+                       last node, its successor's element is moved into it
+                       and the successor's node is returned; if anchor was
+                       that successor it is set to the victim.
+------------------------------------------------------------------------------*/
+
+    vector<int> chunkMarks(int grain, int &length) const;
+    /*--------------------------------------------------------------------------
+        Mark the chain for splitting into chunks, in one walk.
+
+        Precondition:  grain >= 1.
+        Postcondition: Returns the index of the nodes at positions 0, grain,
+                       2 * grain,... (empty if the list is empty) and sets
+                       length to the number of elements.
+------------------------------------------------------------------------------*/
+
+    template <typename Prepare, typename ChunkTask>
+    void runOnChunks(Prepare prepare, ChunkTask task, int threadCount,
+                     int grain) const;
+    /*--------------------------------------------------------------------------
+        Split the list into balanced chunks and run a task on each one.
+
+        Precondition:  task(chunk, node, count) may be called from several
+                       threads at once.
+        Postcondition: The marks of chunkMarks() are shared evenly among
+                       chunkCountFor() chunks; prepare(chunkCount) has run on
+                       the calling thread, then task(c, node, count) for
+                       every chunk c (numbered in list order) with the index
+                       of its first node and its number of nodes, through
+                       runChunks().
+------------------------------------------------------------------------------*/
+
+    static uint64_t checksum(uint64_t hash, const char *bytes, size_t length);
+    /*--------------------------------------------------------------------------
+        Continue an FNV-1a checksum over a block of bytes.
+
+        Precondition:  hash is the FNV offset basis or a previous result.
+        Postcondition: Returns the checksum updated with the block.
+------------------------------------------------------------------------------*/
+
+    NodePool<ElementType, Capacity> nodePool; // NodePool object to store data
+    int first;                                // first element in the list
+    mutable Instrumentation instrumentation;  // statistics (may be empty)
+    mutable typename Eviction::template Policy<ElementType, Capacity>
+        eviction;                             // victim of forced inserts
 
 }; // end of class declaration
 
 // Definition of constructor
-template <typename ElementType>
-ArrayBasedList<ElementType>::ArrayBasedList() : first(NULL_INDEX) {}
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::ArrayBasedList() : first(NULL_INDEX) {}
+
+// Definition of constructor from an iterator range
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+template <typename ForwardIterator>
+ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::ArrayBasedList(
+    ForwardIterator rangeBegin, ForwardIterator rangeEnd)
+    : first(NULL_INDEX)
+{
+    insertChain(NULL_INDEX, rangeBegin, rangeEnd, false);
+}
+
+// Definition of constructor from an initializer_list
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::ArrayBasedList(
+    initializer_list<ElementType> values)
+    : first(NULL_INDEX)
+{
+    insertChain(NULL_INDEX, values.begin(), values.end(), false);
+}
+
+// Definition of constructor with a memory resource
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::ArrayBasedList(
+    pmr::memory_resource *resource)
+    : nodePool(resource), first(NULL_INDEX) {}
+
+// Definition of move constructor
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::ArrayBasedList(
+    ArrayBasedList &&other)
+    noexcept(is_nothrow_move_constructible<NodePool<ElementType, Capacity>>::value)
+    : nodePool(move(other.nodePool)), first(other.first),
+      instrumentation(other.instrumentation), eviction(other.eviction)
+{
+    other.clear(); // its nodes now belong to this list
+}
+
+// Definition of move assignment operator
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction> &
+ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::operator=(
+    ArrayBasedList &&other)
+{
+    if (this == &other)
+        return *this;
+
+    nodePool = move(other.nodePool); // may copy (and throw) first
+    first = other.first;
+    instrumentation = other.instrumentation;
+    eviction = other.eviction;
+    other.clear();
+    return *this;
+}
+
+// Definition of Appender constructor
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::Appender::Appender(ArrayBasedList &list)
+    : list(list), last(list.first)
+{
+    // Walk once to the last node
+    if (last != NULL_INDEX)
+    {
+        while (list.nodePool.getNextOfNode(last) != NULL_INDEX)
+            last = list.nodePool.getNextOfNode(last);
+    }
+}
+
+// Definition of Appender append()
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+bool ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::Appender::append(const ElementType &value)
+{
+    int newNode = list.acquireNode(); // get free node
+    if (newNode == NULL_INDEX)                 // list is full
+        return false;
+
+    list.nodePool.setNodeData(newNode, value);
+    list.link(newNode, NULL_INDEX);
+    if (last == NULL_INDEX) // list was empty
+        list.setFirst(newNode);
+    else
+        list.link(last, newNode);
+    list.eviction.accessed(newNode);
+    last = newNode;
+    return true;
+}
+
+// Definition of const_iterator no-arg constructor
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::const_iterator::const_iterator()
+    : pool(nullptr), index(NULL_INDEX) {}
+
+// Definition of const_iterator constructor with pool and index
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::const_iterator::const_iterator(
+    const NodePool<ElementType, Capacity> *pool, int index)
+    : pool(pool), index(index) {}
+
+// Definition of const_iterator operator*()
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+typename ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::const_iterator::reference
+ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::const_iterator::operator*() const
+{
+    return pool->nodeData(index);
+}
+
+// Definition of const_iterator operator->()
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+typename ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::const_iterator::pointer
+ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::const_iterator::operator->() const
+{
+    return &pool->nodeData(index);
+}
+
+// Definition of const_iterator prefix operator++()
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+typename ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::const_iterator &
+ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::const_iterator::operator++()
+{
+    index = pool->getNextOfNode(index);
+    return *this;
+}
+
+// Definition of const_iterator postfix operator++()
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+typename ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::const_iterator
+ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::const_iterator::operator++(int)
+{
+    const_iterator old = *this;
+    index = pool->getNextOfNode(index);
+    return old;
+}
+
+// Definition of const_iterator operator==()
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+bool ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::const_iterator::operator==(
+    const const_iterator &other) const
+{
+    return index == other.index;
+}
+
+// Definition of const_iterator operator!=()
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+bool ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::const_iterator::operator!=(
+    const const_iterator &other) const
+{
+    return index != other.index;
+}
+
+// Definition of const_iterator nodeIndex()
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+int ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::const_iterator::nodeIndex() const
+{
+    return index;
+}
+
+// Definition of Segment constructor
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::Segment::Segment()
+    : head(NULL_INDEX), tail(NULL_INDEX), length(0) {}
+
+// Definition of Segment isEmpty()
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+bool ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::Segment::isEmpty() const
+{
+    return head == NULL_INDEX;
+}
+
+// Definition of Segment size()
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+int ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::Segment::size() const
+{
+    return length;
+}
+
+// Definition of begin()
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+typename ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::const_iterator
+ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::begin() const
+{
+    return const_iterator(&nodePool, first);
+}
+
+// Definition of end()
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+typename ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::const_iterator
+ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::end() const
+{
+    return const_iterator(&nodePool, NULL_INDEX);
+}
 
 // Definition of isEmpty()
-template <typename ElementType>
-bool ArrayBasedList<ElementType>::isEmpty() const
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+bool ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::isEmpty() const
 {
     return first == NULL_INDEX;
 }
 
 // Definition of insertAtPosition()
-template <typename ElementType>
-bool ArrayBasedList<ElementType>::insertAtPosition(const ElementType &value,
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+bool ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::insertAtPosition(const ElementType &value,
                                                    int position, bool forced)
 {
-    if (position < 0 || position >= CAPACITY) // Invalid index
+    typename Instrumentation::Timer timer(instrumentation, LIST_OP_INSERT_AT_POSITION);
+
+    if (position < 0 || position >= nodePool.maxSize()) // Invalid index
     {
         return false;
     }
@@ -225,8 +1086,16 @@ bool ArrayBasedList<ElementType>::insertAtPosition(const ElementType &value,
     {
         if (position == 0) // Insert at beginning of empty list
         {
-            first = nodePool.acquireNode();             // get free node and assign it to first
-            nodePool.setNode(first, value, NULL_INDEX); // set data of first node
+            int newNode = acquireNode();              // get free node
+            if (newNode == NULL_INDEX)                // Segments hold every node
+            {
+                instrumentation.failedInsert();
+                return false;
+            }
+            nodePool.setNodeData(newNode, value);     // set data of first node
+            link(newNode, NULL_INDEX);
+            setFirst(newNode);
+            eviction.accessed(newNode);
             return true;
         }
         else // Can not insert in the middle (or end) of an empty list
@@ -234,79 +1103,167 @@ bool ArrayBasedList<ElementType>::insertAtPosition(const ElementType &value,
             return false;
         }
     }
-    else // List is not empty
+
+    // A full list only takes a forced insert
+    bool full = nodePool.usedCount() == nodePool.maxSize();
+    if (full && !forced)
+    {
+        instrumentation.failedInsert();
+        return false;
+    }
+
+    int anchor = NULL_INDEX; // node to insert after (NULL_INDEX: at the beginning)
+    if (position > 0) // Insert in non-empty list
     {
-        if (position == 0) // Insert at beginning of non-empty list
+        int temp = first;                // To traverse the list
+        int count = 1;                   // Counter to stop at position - 1
+        // Loop until either the end of the list or we are at position - 1
+        while (nodePool.getNextOfNode(temp) != NULL_INDEX && count < position)
         {
-            int newNode = nodePool.acquireNode(); // get free node
-            if (newNode == NULL_INDEX)            // list is full
-            {
-                if (forced) // replace data of first node with new data (faster than removing node at 0 then inserting node at 0)
-                {
-                    nodePool.setNodeData(first, value); // change data of first
-                    return true;
-                }
-                else
-                {
-                    return false;
-                }
-            }
-            // set data of first node and let it point to old first
-            nodePool.setNode(newNode, value, first);
-            first = newNode; // set first to newNode
-            return true;
+            temp = nodePool.getNextOfNode(temp);
+            count++;
         }
-        else // Insert in non-empty list
-        {
-            int temp = first; // To traverse the list
-            int count = 1;    // Counter to stop at position - 1
-            // Loop until either the end of the list or we are at position - 1
-            while (nodePool.getNextOfNode(temp) != NULL_INDEX && count < position)
-            {
-                temp = nodePool.getNextOfNode(temp);
-                count++;
-            }
+        instrumentation.traversed(count);
 
-            if (count < position) // position not reached (list is too small)
-            {
-                return false;
-            }
+        if (count < position) // position not reached (list is too small)
+        {
+            return false;
+        }
+        anchor = temp;
+    }
 
-            int newNode = nodePool.acquireNode(); // get free node
-            if (newNode == NULL_INDEX)            // list is full
-            {
-                if (forced) // free first then set newNode to it (THERE IS A BETTER WAY TO DO IT!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!)
-                {
-                    int other = first; // temporary index for deletion
-                    // point first to the second element in the list
-                    first = nodePool.getNextOfNode(first);
+    // The position is valid: only now choose the victim, so that a rejected
+    // insert leaves the eviction policy's state (clock hand, cursor) alone
+    int victim = NULL_INDEX; // node to evict, if any
+    if (full)
+    {
+        // The victim is at or before the last node, so once it is removed
+        // the end of the list is past the end
+        if (anchor != NULL_INDEX && nodePool.getNextOfNode(anchor) == NULL_INDEX)
+            return false;
 
-                    temp = nodePool.getNextOfNode(temp);
-                    newNode = other;
-                }
-                else
-                {
-                    return false;
-                }
+        victim = eviction.victim(nodePool, first);
+        if (victim == NULL_INDEX) // nothing may be evicted
+        {
+            instrumentation.failedInsert();
+            return false;
+        }
+
+        // The victim is removed first, so when it comes at or before the
+        // insertion point the new element goes one node further
+        if (anchor != NULL_INDEX)
+        {
+            int temp = first;
+            int count = 1;
+            while (temp != anchor && temp != victim)
+            {
+                temp = nodePool.getNextOfNode(temp);
+                count++;
             }
+            instrumentation.traversed(count);
+            if (temp == victim)
+                anchor = nodePool.getNextOfNode(anchor);
+        }
+    }
 
-            // temp is now the index which we must insert after
-            // Set next of newNode to be the next of temp (place newNode before the next of temp)
-            nodePool.setNode(newNode, value, nodePool.getNextOfNode(temp));
+    int newNode; // node that will hold value
+    if (victim != NULL_INDEX)
+    {
+        instrumentation.forcedEviction();
+        newNode = evict(victim, anchor);
+    }
+    else
+    {
+        newNode = acquireNode(); // get free node
+        if (newNode == NULL_INDEX) // growable pool could not grow
+        {
+            instrumentation.failedInsert();
+            return false;
+        }
+    }
 
-            // Change temp to point to newNode (place newNode after temp)
-            nodePool.setNextOfNode(temp, newNode);
-            return true;
+    nodePool.setNodeData(newNode, value);
+    if (anchor == NULL_INDEX) // insert at beginning, newNode points to old first
+    {
+        link(newNode, first);
+        setFirst(newNode);
+    }
+    else // place newNode between anchor and its next
+    {
+        link(newNode, nodePool.getNextOfNode(anchor));
+        link(anchor, newNode);
+    }
+    eviction.accessed(newNode);
+    return true;
+}
+
+// Definition of insertRange()
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+template <typename ForwardIterator>
+int ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::insertRange(
+    int position, ForwardIterator rangeBegin, ForwardIterator rangeEnd, bool forced)
+{
+    typename Instrumentation::Timer timer(instrumentation, LIST_OP_INSERT_RANGE);
+
+    if (position < 0)
+        return 0;
+
+    // Walk once to the node at position - 1
+    int anchor = NULL_INDEX; // node to insert after (NULL_INDEX: at the beginning)
+    if (position > 0)
+    {
+        if (first == NULL_INDEX) // Can not insert in the middle of an empty list
+            return 0;
+
+        int count = 1; // Counter to stop at position - 1
+        anchor = first;
+        while (nodePool.getNextOfNode(anchor) != NULL_INDEX && count < position)
+        {
+            anchor = nodePool.getNextOfNode(anchor);
+            count++;
+        }
+        instrumentation.traversed(count);
+
+        if (count < position) // position not reached (list is too small)
+            return 0;
+    }
+    return insertChain(anchor, rangeBegin, rangeEnd, forced);
+}
+
+// Definition of appendRange()
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+template <typename ForwardIterator>
+int ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::appendRange(
+    ForwardIterator rangeBegin, ForwardIterator rangeEnd, bool forced)
+{
+    typename Instrumentation::Timer timer(instrumentation, LIST_OP_INSERT_RANGE);
+
+    // Walk once to the last node
+    int anchor = first;
+    if (anchor != NULL_INDEX)
+    {
+        int count = 1;
+        while (nodePool.getNextOfNode(anchor) != NULL_INDEX)
+        {
+            anchor = nodePool.getNextOfNode(anchor);
+            count++;
         }
+        instrumentation.traversed(count);
     }
+    return insertChain(anchor, rangeBegin, rangeEnd, forced);
 }
 
 // Definition of deleteAtPosition()
-template <typename ElementType>
-bool ArrayBasedList<ElementType>::deleteAtPosition(int position)
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+bool ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::deleteAtPosition(int position)
 {
+    typename Instrumentation::Timer timer(instrumentation, LIST_OP_DELETE_AT_POSITION);
+
     // Check if list is empty or invalid position
-    if (first == NULL_INDEX || position < 0 || position >= CAPACITY)
+    if (first == NULL_INDEX || position < 0 || position >= nodePool.maxSize())
     {
         return false;
     }
@@ -315,176 +1272,732 @@ bool ArrayBasedList<ElementType>::deleteAtPosition(int position)
     {
         int temp = first; // temporary index for deletion
         // point first to the second element in the list
-        first = nodePool.getNextOfNode(first);
+        setFirst(nodePool.getNextOfNode(first));
+
+        releaseNode(temp); // delete temp (old first)
+        return true;
+    }
+    else
+    {
+        int count = 1;    // Counter to stop at position - 1
+        int temp = first; // To traverse the list
+
+        // Loop until either the end of the list or we are at position - 1
+        while (nodePool.getNextOfNode(temp) != NULL_INDEX && count < position)
+        {
+            temp = nodePool.getNextOfNode(temp);
+            count++;
+        }
+        instrumentation.traversed(count);
+
+        // temp is now the index which we must delete after
+
+        int deleted = nodePool.getNextOfNode(temp); // index of node to be deleted
+        if (deleted == NULL_INDEX)                  // temp is the last node, we cannot delete after it
+        {
+            return false;
+        }
+
+        // point temp to the node 2 positions after it
+        link(temp, nodePool.getNextOfNode(deleted));
+
+        releaseNode(deleted); // delete node at position
+        return true;
+    }
+}
+
+// Definition of search()
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+int ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::search(const ElementType &data) const
+{
+    typename Instrumentation::Timer timer(instrumentation, LIST_OP_SEARCH);
+    int position = 0; // logical position of node with data in the list
+
+    // Loop through the entire list
+    for (int i = first; i != NULL_INDEX; i = nodePool.getNextOfNode(i))
+    {
+        if (nodePool.getNodeData(i) == data) // found data
+        {
+            instrumentation.traversed(position + 1);
+            eviction.accessed(i);
+            return position;
+        }
+        position++; // increment logical position
+    }
+    // data not found
+    instrumentation.traversed(position);
+    return NULL_INDEX;
+}
+
+// Definition of searchMany()
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+int ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::searchMany(
+    const ElementType *keys, int keyCount, int *positions) const
+{
+    typename Instrumentation::Timer timer(instrumentation, LIST_OP_SEARCH_MANY);
+
+    // Indices of the keys, sorted by key
+    static thread_local vector<int> order;
+    order.resize(keyCount);
+    for (int k = 0; k < keyCount; k++)
+    {
+        order[k] = k;
+        positions[k] = NULL_INDEX;
+    }
+    std::sort(order.begin(), order.end(),
+              [keys](int a, int b) { return keys[a] < keys[b]; });
+
+    int remaining = 0; // distinct keys not found yet
+    for (int k = 0; k < keyCount; k++)
+    {
+        if (k == 0 || keys[order[k - 1]] < keys[order[k]])
+            remaining++;
+    }
+
+    int found = 0;    // keys found
+    int position = 0; // logical position of node i
+    for (int i = first; i != NULL_INDEX && remaining > 0; i = nodePool.getNextOfNode(i))
+    {
+        const ElementType &data = nodePool.nodeData(i);
+        vector<int>::iterator run = lower_bound(
+            order.begin(), order.end(), data,
+            [keys](int k, const ElementType &value) { return keys[k] < value; });
+
+        // First occurrence of a key: answer every copy of it
+        if (run != order.end() && !(data < keys[*run]) && positions[*run] == NULL_INDEX)
+        {
+            for (; run != order.end() && !(data < keys[*run]); ++run)
+            {
+                positions[*run] = position;
+                found++;
+            }
+            remaining--;
+            eviction.accessed(i);
+        }
+        position++;
+    }
+    instrumentation.traversed(position);
+    return found;
+}
+
+// Definition of display()
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+void ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::display(ostream &out) const
+{
+    if (first == NULL_INDEX) // list is empty
+    {
+        out << "List is empty";
+    }
+    else
+    {
+        // call nodePool method to display elements in order starting from
+        // first index
+        nodePool.displayInUse(out, first);
+    }
+    out << '\n';
+}
+
+// Definition of displayFreeNodes()
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+void ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::displayFreeNodes(ostream &out) const
+{
+    nodePool.displayFree(out); // call nodePool method to display free nodes
+}
+
+// Definition of poolStats()
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+PoolStats ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::poolStats() const
+{
+    return nodePool.occupancy(first); // walk the free list and our chain
+}
+
+// Definition of shrinkPool()
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+int ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::shrinkPool()
+{
+    return nodePool.shrink();
+}
+
+// Definition of displayFreeNodes()
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+void ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::sort()
+{
+    typename Instrumentation::Timer timer(instrumentation, LIST_OP_SORT);
+
+    if (first != NULL_INDEX)
+    {
+        // Get list size
+        int size = 0; // size of the list
+
+        // Loop through the entire list
+        for (int i = first; i != NULL_INDEX; i = nodePool.getNextOfNode(i))
+        {
+            size++;
+        }
+
+        // Sort list elements
+        for (int i = 0; i < size - 1; i++)
+        {
+            // Loop through the entire list
+            for (int i = first; nodePool.getNextOfNode(i) != NULL_INDEX; i = nodePool.getNextOfNode(i))
+            {
+                if (nodePool.getNodeData(i) >
+                    nodePool.getNodeData(nodePool.getNextOfNode(i))) // pool[i] > pool[i + 1]
+                {
+                    // switch node i with node i + 1
+                    nodePool.switchOrderOfNodes(i, nodePool.getNextOfNode(i));
+                }
+            }
+        }
+        instrumentation.traversed((uint64_t)size * size);
+    }
+}
+
+// Definition of search()
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+int ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::size() const
+{
+    typename Instrumentation::Timer timer(instrumentation, LIST_OP_SIZE);
+    int size = 0; // size of the list
+
+    // Loop through the entire list
+    for (int i = first; i != NULL_INDEX; i = nodePool.getNextOfNode(i))
+    {
+        size++;
+    }
+    instrumentation.traversed(size);
+    return size;
+}
+
+// Definition of clear()
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+void ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::clear()
+{
+    nodePool.reset(); // every node back on the free list, in physical order
+    first = NULL_INDEX;
+    eviction.reset();
+}
+
+// Encode one element in a snapshot (trivially copyable types)
+template <typename ElementType>
+typename enable_if<is_trivially_copyable<ElementType>::value>::type
+writeSnapshotElement(vector<char> &buffer, const ElementType &value)
+{
+    const char *bytes = reinterpret_cast<const char *>(&value);
+    buffer.insert(buffer.end(), bytes, bytes + sizeof(ElementType));
+}
+
+// Encode one element in a snapshot (strings: length, then characters)
+inline void writeSnapshotElement(vector<char> &buffer, const string &value)
+{
+    uint32_t length = value.size();
+    const char *bytes = reinterpret_cast<const char *>(&length);
+    buffer.insert(buffer.end(), bytes, bytes + sizeof(length));
+    buffer.insert(buffer.end(), value.begin(), value.end());
+}
+
+// Decode one string from a snapshot, adding its bytes to the checksum input.
+// The length is not trusted before the checksum: the string grows one block
+// at a time as its bytes arrive, so a corrupt length fails at the end of the
+// input instead of allocating up to 4 GB.
+inline bool readSnapshotElement(istream &in, string &value, vector<char> &bytes)
+{
+    uint32_t length;
+    if (!in.read(reinterpret_cast<char *>(&length), sizeof(length)))
+        return false;
+    value.clear();
+    while (value.size() < length)
+    {
+        size_t piece = length - value.size();
+        if (piece > SNAPSHOT_BLOCK)
+            piece = SNAPSHOT_BLOCK;
+        size_t start = value.size();
+        value.resize(start + piece);
+        if (!in.read(&value[start], piece))
+            return false;
+    }
+
+    bytes.assign(reinterpret_cast<char *>(&length),
+                 reinterpret_cast<char *>(&length) + sizeof(length));
+    bytes.insert(bytes.end(), value.begin(), value.end());
+    return true;
+}
+
+// Definition of save()
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+bool ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::save(ostream &out) const
+{
+    uint32_t version = SNAPSHOT_VERSION;
+    uint32_t elementSize = is_trivially_copyable<ElementType>::value
+                               ? sizeof(ElementType)
+                               : 0;
+    uint64_t count = 0; // counted directly: size() would record an operation
+    for (int i = first; i != NULL_INDEX; i = nodePool.getNextOfNode(i))
+        count++;
+    instrumentation.traversed(count);
+
+    out.write(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    out.write(reinterpret_cast<const char *>(&version), sizeof(version));
+    out.write(reinterpret_cast<const char *>(&elementSize), sizeof(elementSize));
+    out.write(reinterpret_cast<const char *>(&count), sizeof(count));
+
+    // Encode elements in logical order, writing one block at a time
+    uint64_t hash = 14695981039346656037ull; // FNV offset basis
+    vector<char> buffer;
+    buffer.reserve(SNAPSHOT_BLOCK + sizeof(ElementType));
+
+    for (int i = first; i != NULL_INDEX; i = nodePool.getNextOfNode(i))
+    {
+        writeSnapshotElement(buffer, nodePool.getNodeData(i));
+        if (buffer.size() >= SNAPSHOT_BLOCK) // block full
+        {
+            hash = checksum(hash, buffer.data(), buffer.size());
+            out.write(buffer.data(), buffer.size());
+            buffer.clear();
+        }
+    }
+    hash = checksum(hash, buffer.data(), buffer.size());
+    out.write(buffer.data(), buffer.size());
+    out.write(reinterpret_cast<const char *>(&hash), sizeof(hash));
+
+    return (bool)out;
+}
+
+// Definition of load()
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+bool ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::load(istream &in)
+{
+    clear();
+
+    char magic[sizeof(SNAPSHOT_MAGIC)];
+    uint32_t version, elementSize;
+    uint64_t count;
+    uint32_t expectedSize = is_trivially_copyable<ElementType>::value
+                                ? sizeof(ElementType)
+                                : 0;
+
+    in.read(magic, sizeof(magic));
+    in.read(reinterpret_cast<char *>(&version), sizeof(version));
+    in.read(reinterpret_cast<char *>(&elementSize), sizeof(elementSize));
+    in.read(reinterpret_cast<char *>(&count), sizeof(count));
+    if (!in || memcmp(magic, SNAPSHOT_MAGIC, sizeof(magic)) != 0 ||
+        version != SNAPSHOT_VERSION || elementSize != expectedSize ||
+        count > (uint64_t)nodePool.maxSize())
+    {
+        return false;
+    }
+
+    // The pool was just reset, so nodes 0, 1,..., count - 1 are acquired in
+    // order and linked as one contiguous chain
+    uint64_t hash = 14695981039346656037ull; // FNV offset basis
+    Appender appender(*this);                // links each node after the last
+
+    if constexpr (is_trivially_copyable<ElementType>::value)
+    {
+        // Fast path: read whole blocks of elements at once
+        const uint64_t perBlock = SNAPSHOT_BLOCK / sizeof(ElementType) + 1;
+        vector<ElementType> block(count < perBlock ? count : perBlock);
+        uint64_t remaining = count;
+
+        while (remaining > 0)
+        {
+            uint64_t batch = remaining < perBlock ? remaining : perBlock;
+            char *bytes = reinterpret_cast<char *>(block.data());
+            if (!in.read(bytes, batch * sizeof(ElementType)))
+            {
+                clear();
+                return false;
+            }
+            hash = checksum(hash, bytes, batch * sizeof(ElementType));
+
+            for (uint64_t j = 0; j < batch; j++)
+            {
+                if (!appender.append(block[j])) // a growable pool is out of memory
+                {
+                    clear();
+                    return false;
+                }
+            }
+            remaining -= batch;
+        }
+    }
+    else
+    {
+        ElementType value;
+        vector<char> bytes; // encoded form of value, for the checksum
+        for (uint64_t j = 0; j < count; j++)
+        {
+            if (!readSnapshotElement(in, value, bytes))
+            {
+                clear();
+                return false;
+            }
+            hash = checksum(hash, bytes.data(), bytes.size());
+            if (!appender.append(value)) // a growable pool is out of memory
+            {
+                clear();
+                return false;
+            }
+        }
+    }
+
+    uint64_t stored;
+    if (!in.read(reinterpret_cast<char *>(&stored), sizeof(stored)) || stored != hash)
+    {
+        clear();
+        return false;
+    }
+    return true;
+}
+
+// Definition of stats()
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+ListStats ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::stats() const
+{
+    return instrumentation.snapshot();
+}
+
+// Definition of resetStats()
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+void ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::resetStats()
+{
+    instrumentation.reset();
+}
+
+// Definition of acquireNode()
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+int ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::acquireNode()
+{
+    instrumentation.acquired();
+    return nodePool.acquireNode();
+}
+
+// Definition of releaseNode()
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+void ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::releaseNode(int index)
+{
+    instrumentation.released();
+    eviction.released(index);
+    nodePool.releaseNode(index);
+}
+
+// Definition of link()
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+void ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::link(int node, int next)
+{
+    nodePool.setNextOfNode(node, next);
+    eviction.linked(node, next);
+}
+
+// Definition of setFirst()
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+void ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::setFirst(int node)
+{
+    first = node;
+    eviction.linked(NULL_INDEX, node);
+}
 
-        nodePool.releaseNode(temp); // delete temp (old first)
-        return true;
-    }
-    else
+// Definition of insertChain()
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+template <typename ForwardIterator>
+int ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::insertChain(
+    int anchor, ForwardIterator rangeBegin, ForwardIterator rangeEnd, bool forced)
+{
+    int total = distance(rangeBegin, rangeEnd);     // elements to insert
+    int fitting = nodePool.maxSize() - nodePool.usedCount(); // elements that fit
+    if (fitting > total)
+        fitting = total;
+
+    // Acquire the nodes that fit as one chain, fill them, then splice it
+    int last; // last node of the chain
+    int head = fitting > 0 ? nodePool.acquireChain(fitting, last) : NULL_INDEX;
+    if (head == NULL_INDEX) // nothing fits, or a growable pool could not grow
+        fitting = 0;
+    if (fitting > 0)
     {
-        int count = 1;    // Counter to stop at position - 1
-        int temp = first; // To traverse the list
+        instrumentation.acquired();
 
-        // Loop until either the end of the list or we are at position - 1
-        while (nodePool.getNextOfNode(temp) != NULL_INDEX && count < position)
+        for (int i = head; i != NULL_INDEX; i = nodePool.getNextOfNode(i))
         {
-            temp = nodePool.getNextOfNode(temp);
-            count++;
+            nodePool.setNodeData(i, *rangeBegin);
+            ++rangeBegin;
+            if (i != last) // last's link is reported once the chain is spliced
+                eviction.linked(i, nodePool.getNextOfNode(i));
+            eviction.accessed(i);
         }
 
-        // temp is now the index which we must delete after
-
-        int deleted = nodePool.getNextOfNode(temp); // index of node to be deleted
-        if (deleted == NULL_INDEX)                  // temp is the last node, we cannot delete after it
+        if (anchor == NULL_INDEX) // chain goes at the beginning
         {
-            return false;
+            link(last, first);
+            setFirst(head);
+        }
+        else // chain goes between anchor and its next
+        {
+            link(last, nodePool.getNextOfNode(anchor));
+            link(anchor, head);
         }
+        anchor = last;
+    }
 
-        // point temp to the node 2 positions after it
-        nodePool.setNextOfNode(temp, nodePool.getNextOfNode(deleted));
+    // Pool is full: the rest is inserted one element at a time, if forced
+    int inserted = fitting;
+    for (; inserted < total && forced && first != NULL_INDEX; inserted++, ++rangeBegin)
+    {
+        int victim = eviction.victim(nodePool, first);
+        if (victim == NULL_INDEX) // nothing may be evicted
+            break;
+        instrumentation.forcedEviction();
 
-        nodePool.releaseNode(deleted); // delete node at position
-        return true;
+        if (victim == anchor) // new element takes the place of the previous one
+        {
+            nodePool.setNodeData(anchor, *rangeBegin);
+            eviction.accessed(anchor);
+            continue;
+        }
+        int newNode = evict(victim, anchor);
+        nodePool.setNodeData(newNode, *rangeBegin);
+        if (anchor == NULL_INDEX) // insert at beginning
+        {
+            link(newNode, first);
+            setFirst(newNode);
+        }
+        else
+        {
+            link(newNode, nodePool.getNextOfNode(anchor));
+            link(anchor, newNode);
+        }
+        eviction.accessed(newNode);
+        anchor = newNode;
     }
+    if (inserted < total)
+        instrumentation.failedInsert();
+    return inserted;
 }
 
-// Definition of search()
-template <typename ElementType>
-int ArrayBasedList<ElementType>::search(const ElementType &data) const
+// Definition of evict()
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+int ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::evict(int victim, int &anchor)
 {
-    int position = 0; // logical position of node with data in the list
+    int next = nodePool.getNextOfNode(victim); // successor of the victim
 
-    // Loop through the entire list
-    for (int i = first; i != NULL_INDEX; i = nodePool.getNextOfNode(i))
+    if (victim == first) // unlink the first node
     {
-        if (nodePool.getNodeData(i) == data) // found data
+        setFirst(next);
+        return victim;
+    }
+    if (next != NULL_INDEX) // copy the successor into the victim, unlink the successor
+    {
+        nodePool.setNodeData(victim, nodePool.nodeData(next));
+        link(victim, nodePool.getNextOfNode(next));
+        eviction.moved(next, victim);
+        if (anchor == next)
+            anchor = victim;
+        return next;
+    }
+
+    // The victim is the last node: unlink it from its predecessor
+    int prev = eviction.predecessor(victim);
+    if (prev == NULL_INDEX) // the policy does not know it, walk
+    {
+        int visited = 1;
+        prev = first;
+        while (nodePool.getNextOfNode(prev) != victim)
         {
-            return position;
+            prev = nodePool.getNextOfNode(prev);
+            visited++;
         }
-        position++; // increment logical position
+        instrumentation.traversed(visited);
     }
-    // data not found
-    return NULL_INDEX;
+    link(prev, NULL_INDEX);
+    return victim;
 }
 
-// Definition of display()
-template <typename ElementType>
-void ArrayBasedList<ElementType>::display(ostream &out) const
+// Definition of checksum()
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+uint64_t ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::checksum(uint64_t hash,
+                                                        const char *bytes,
+                                                        size_t length)
 {
-    if (first == NULL_INDEX) // list is empty
+    for (size_t i = 0; i < length; i++)
     {
-        out << "List is empty";
-    }
-    else
-    {
-        // call nodePool method to display elements in order starting from
-        // first index
-        nodePool.displayInUse(out, first);
+        hash ^= (unsigned char)bytes[i];
+        hash *= 1099511628211ull; // FNV prime
     }
-    out << endl;
+    return hash;
 }
 
-// Definition of displayFreeNodes()
+// Integers that dump() may format with to_chars (bool and characters keep
+// the operator<< form so that dump() matches display(); floating point
+// always goes through operator<< to honour the stream's precision)
 template <typename ElementType>
-void ArrayBasedList<ElementType>::displayFreeNodes(ostream &out) const
+struct DumpsWithToChars
+    : integral_constant<bool, is_integral<ElementType>::value &&
+                                  !is_same<ElementType, bool>::value &&
+                                  !is_same<ElementType, char>::value &&
+                                  !is_same<ElementType, signed char>::value &&
+                                  !is_same<ElementType, unsigned char>::value>
 {
-    nodePool.displayFree(out); // call nodePool method to display free nodes
-}
+};
 
-// Definition of displayFreeNodes()
+// Append one element to a dump buffer (integers: to_chars when the stream
+// prints plain decimal in the classic locale, otherwise operator<<)
 template <typename ElementType>
-void ArrayBasedList<ElementType>::sort()
+typename enable_if<DumpsWithToChars<ElementType>::value>::type
+formatDumpElement(string &buffer, const ElementType &value,
+                  ostringstream &formatter, bool plainDecimal)
 {
-    if (first != NULL_INDEX)
+    if (!plainDecimal)
     {
-        // Get list size
-        int size = 0; // size of the list
-
-        // Loop through the entire list
-        for (int i = first; i != NULL_INDEX; i = nodePool.getNextOfNode(i))
-        {
-            size++;
-        }
-
-        // Sort list elements
-        for (int i = 0; i < size - 1; i++)
-        {
-            // Loop through the entire list
-            for (int i = first; nodePool.getNextOfNode(i) != NULL_INDEX; i = nodePool.getNextOfNode(i))
-            {
-                if (nodePool.getNodeData(i) >
-                    nodePool.getNodeData(nodePool.getNextOfNode(i))) // pool[i] > pool[i + 1]
-                {
-                    // switch node i with node i + 1
-                    nodePool.switchOrderOfNodes(i, nodePool.getNextOfNode(i));
-                }
-            }
-        }
+        formatter.str(string());
+        formatter << value;
+        buffer += formatter.str();
+        return;
     }
+    char digits[64]; // enough for any integer
+    to_chars_result result = to_chars(digits, digits + sizeof(digits), value);
+    buffer.append(digits, result.ptr);
 }
 
-// Definition of search()
+// Append one element to a dump buffer (other types: their operator<<, with
+// the flags, precision and locale of the output stream)
 template <typename ElementType>
-int ArrayBasedList<ElementType>::size() const
+typename enable_if<!DumpsWithToChars<ElementType>::value>::type
+formatDumpElement(string &buffer, const ElementType &value,
+                  ostringstream &formatter, bool)
 {
-    int size = 0; // size of the list
+    formatter.str(string());
+    formatter << value;
+    buffer += formatter.str();
+}
 
-    // Loop through the entire list
-    for (int i = first; i != NULL_INDEX; i = nodePool.getNextOfNode(i))
+// Append one string element to a dump buffer
+inline void formatDumpElement(string &buffer, const string &value,
+                              ostringstream &, bool)
+{
+    buffer += value;
+}
+
+// Definition of dump()
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+int ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::dump(ostream &out, int offset,
+                                               int limit) const
+{
+    static thread_local string buffer; // reused between calls
+    buffer.clear();
+
+    if (first == NULL_INDEX) // list is empty
     {
-        size++;
+        out.write("List is empty\n", 14);
+        return 0;
     }
-    return size;
+
+    // Format like out: same flags, precision and locale (but no width, which
+    // would only apply to the first element)
+    static thread_local ostringstream formatter; // reused between calls
+    formatter.copyfmt(out);
+    formatter.exceptions(ios::goodbit);
+    formatter.width(0);
+    bool plainDecimal =
+        (out.flags() & (ios::basefield | ios::showpos)) == ios::dec &&
+        out.getloc() == locale::classic();
+
+    // Skip to the first element of the page
+    int i = first;
+    for (int skipped = 0; i != NULL_INDEX && skipped < offset; skipped++)
+        i = nodePool.getNextOfNode(i);
+
+    int written = 0; // elements formatted so far
+    for (; i != NULL_INDEX && written != limit; i = nodePool.getNextOfNode(i))
+    {
+        if (written > 0)
+            buffer += ", ";
+        formatDumpElement(buffer, nodePool.getNodeData(i), formatter, plainDecimal);
+        written++;
+
+        if (buffer.size() >= DUMP_BLOCK) // block full, hand it to the stream
+        {
+            out.write(buffer.data(), buffer.size());
+            buffer.clear();
+        }
+    }
+    buffer += '\n';
+    out.write(buffer.data(), buffer.size());
+    return written;
 }
 
 // Overload operator<< to display list elements
-template <typename ElementType>
-ostream &operator<<(ostream &out, ArrayBasedList<ElementType> list)
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+ostream &operator<<(ostream &out, const ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction> &list)
 {
-    list.display(out);
+    list.dump(out);
     return out;
 }
 
-template <typename ElementType>
-bool ArrayBasedList<ElementType>::insertAfterValue(const ElementType &value,
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+bool ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::insertAfterValue(const ElementType &value,
                                                    const ElementType &target,
                                                    bool forced)
 {
+    typename Instrumentation::Timer timer(instrumentation, LIST_OP_INSERT_AFTER_VALUE);
+
     if (first == NULL_INDEX) // list is empty
         return false;
 
     // Traverse the list to find target
     for (int i = first; i != NULL_INDEX; i = nodePool.getNextOfNode(i))
     {
+        instrumentation.traversed(1);
         if (nodePool.getNodeData(i) == target) // Found target, now insert after it
         {
-            int newNode = nodePool.acquireNode();
+            int newNode = acquireNode();
 
             if (newNode == NULL_INDEX) // List is Full
             {
-                if (forced) // replace data of first node with new data (faster than removing node at 0 then inserting node at 0)
+                int victim = forced ? eviction.victim(nodePool, first) : NULL_INDEX;
+                if (victim == NULL_INDEX) // not forced, or nothing may be evicted
                 {
-                    if (i == first)
-                    {
-                        nodePool.setNodeData(first, value); // change data of first
-                        return true;
-                    }
-                    int other = first; // temporary index for deletion
-                    // point first to the second element in the list
-                    first = nodePool.getNextOfNode(first);
-
-                    newNode = other;
+                    instrumentation.failedInsert();
+                    return false;
                 }
-                else
+                instrumentation.forcedEviction();
+                if (victim == i) // new element takes the place of target
                 {
-                    return false;
+                    nodePool.setNodeData(i, value);
+                    eviction.accessed(i);
+                    return true;
                 }
+                newNode = evict(victim, i);
             }
             // new node points to what target was pointing to
-            nodePool.setNode(newNode, value, nodePool.getNextOfNode(i));
+            nodePool.setNodeData(newNode, value);
+            link(newNode, nodePool.getNextOfNode(i));
 
             // target now points to new node
-            nodePool.setNextOfNode(i, newNode);
+            link(i, newNode);
+            eviction.accessed(newNode);
             return true;
         }
     }
@@ -492,81 +2005,86 @@ bool ArrayBasedList<ElementType>::insertAfterValue(const ElementType &value,
     return false;
 }
 
-template <typename ElementType>
-bool ArrayBasedList<ElementType>::insertBeforeValue(const ElementType &value,
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+bool ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::insertBeforeValue(const ElementType &value,
                                                     const ElementType &target, bool forced)
 {
+    typename Instrumentation::Timer timer(instrumentation, LIST_OP_INSERT_BEFORE_VALUE);
+
     // List empty
     if (first == NULL_INDEX)
         return false;
 
-    // Case 1: target is in the first node
-    if (nodePool.getNodeData(first) == target)
-    {
-        int newNode = nodePool.acquireNode();
-        if (newNode == NULL_INDEX)
-        {               // list full {
-            if (forced) // replace data of first node with new data (faster than removing node at 0 then inserting node at 0)
-            {
-                nodePool.setNodeData(first, value); // change data of first
-                return true;
-            }
-            else
-            {
-                return false;
-            }
-        }
-
-        nodePool.setNode(newNode, value, first);
-        first = newNode;
-        return true;
-    }
-
-    // Case 2: target is in middle or end
-    int prev = first;
-    int curr = nodePool.getNextOfNode(first);
+    // Find target, remembering the node before it (NULL_INDEX if target is first)
+    int prev = NULL_INDEX;
+    int curr = first;
 
     while (curr != NULL_INDEX && nodePool.getNodeData(curr) != target)
     {
+        instrumentation.traversed(1);
         prev = curr;
         curr = nodePool.getNextOfNode(curr);
     }
     if (curr == NULL_INDEX)
         return false; // target not found
 
-    int newNode = nodePool.acquireNode();
-    if (newNode == NULL_INDEX)
+    int newNode = acquireNode();
+    if (newNode == NULL_INDEX) // list full
     {
-        if (forced) // replace data of first node with new data (faster than removing node at 0 then inserting node at 0)
+        int victim = forced ? eviction.victim(nodePool, first) : NULL_INDEX;
+        if (victim == NULL_INDEX) // not forced, or nothing may be evicted
         {
-            int other = first; // temporary index for deletion
-            // point first to the second element in the list
-            first = nodePool.getNextOfNode(first);
-
-            newNode = other;
+            instrumentation.failedInsert();
+            return false;
         }
-        else
+        instrumentation.forcedEviction();
+        if (victim == curr) // new element takes the place of target
         {
-            return false;
+            nodePool.setNodeData(curr, value);
+            eviction.accessed(curr);
+            return true;
         }
+
+        // prev may be the victim, so insert after curr and swap the elements:
+        // the freed node takes target and curr takes the new element
+        newNode = evict(victim, curr);
+        nodePool.setNodeData(newNode, nodePool.nodeData(curr));
+        link(newNode, nodePool.getNextOfNode(curr));
+        eviction.moved(curr, newNode);
+
+        nodePool.setNodeData(curr, value);
+        link(curr, newNode);
+        eviction.accessed(curr);
+        return true;
     }
+
     // new node stores the given value and points to the current node (curr)
-    nodePool.setNode(newNode, value, curr);
+    nodePool.setNodeData(newNode, value);
+    link(newNode, curr);
 
-    // previous node now points to the new node, linking it into the list
-    nodePool.setNextOfNode(prev, newNode);
+    // previous node (or first) now points to the new node, linking it into the list
+    if (prev == NULL_INDEX)
+        setFirst(newNode);
+    else
+        link(prev, newNode);
+    eviction.accessed(newNode);
     return true;
 }
 
-template <typename ElementType>
-bool ArrayBasedList<ElementType>::deleteAfterValue(const ElementType &target)
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+bool ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::deleteAfterValue(const ElementType &target)
 {
+    typename Instrumentation::Timer timer(instrumentation, LIST_OP_DELETE_AFTER_VALUE);
+
     if (first == NULL_INDEX) // list is empty
         return false;
 
     // Traverse the list to find the target
     for (int i = first; i != NULL_INDEX; i = nodePool.getNextOfNode(i))
     {
+        instrumentation.traversed(1);
         if (nodePool.getNodeData(i) == target)
         {
             int nodeToDelete = nodePool.getNextOfNode(i); // node after target
@@ -577,19 +2095,22 @@ bool ArrayBasedList<ElementType>::deleteAfterValue(const ElementType &target)
             }
 
             // Link target node to the node after nodeToDelete
-            nodePool.setNextOfNode(i, nodePool.getNextOfNode(nodeToDelete));
+            link(i, nodePool.getNextOfNode(nodeToDelete));
 
             // Release the deleted node back to the NodePool
-            nodePool.releaseNode(nodeToDelete);
+            releaseNode(nodeToDelete);
             return true;
         }
     }
     return false; // Target not found
 }
 
-template <typename ElementType>
-bool ArrayBasedList<ElementType>::deleteBeforeValue(const ElementType &target)
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+bool ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::deleteBeforeValue(const ElementType &target)
 {
+    typename Instrumentation::Timer timer(instrumentation, LIST_OP_DELETE_BEFORE_VALUE);
+
     // Case 1: list is empty or first node is the target
     if (first == NULL_INDEX || nodePool.getNodeData(first) == target)
     {
@@ -598,11 +2119,13 @@ bool ArrayBasedList<ElementType>::deleteBeforeValue(const ElementType &target)
 
     // Case 1: target is in the second node
     int temp = nodePool.getNextOfNode(first);
-    if (temp != NULL_INDEX && nodePool.getNodeData(temp) == target)
+    if (temp == NULL_INDEX) // single node, which is not the target
+        return false;
+    if (nodePool.getNodeData(temp) == target)
     {
         int nodeToDelete = first;                // node to delete is the first node
-        first = nodePool.getNextOfNode((first)); // update first to point to the second node
-        nodePool.releaseNode(nodeToDelete);      // release the deleted node back to NodePool
+        setFirst(nodePool.getNextOfNode(first)); // update first to point to the second node
+        releaseNode(nodeToDelete);               // release the deleted node back to NodePool
         return true;
     }
 
@@ -614,14 +2137,15 @@ bool ArrayBasedList<ElementType>::deleteBeforeValue(const ElementType &target)
     // Traverse until target is found or end of list
     while (curr != NULL_INDEX && nodePool.getNodeData(curr) != target)
     {
+        instrumentation.traversed(1);
         prevPrev = prev;
         prev = curr;
         curr = nodePool.getNextOfNode(curr);
     }
     if (curr != NULL_INDEX)
-    {                                                                   // target found
-        nodePool.setNextOfNode(prevPrev, nodePool.getNextOfNode(prev)); // skip the node before target
-        nodePool.releaseNode(prev);                                     // release deleted node back to NodePool
+    {                                                 // target found
+        link(prevPrev, nodePool.getNextOfNode(prev)); // skip the node before target
+        releaseNode(prev);                            // release deleted node back to NodePool
         return true;
     }
     return false; // target not found or no node to delete
@@ -629,9 +2153,12 @@ bool ArrayBasedList<ElementType>::deleteBeforeValue(const ElementType &target)
 
 // Delete first occurrence of a node with the given value
 
-template <typename ElementType>
-bool ArrayBasedList<ElementType>::deleteValue(const ElementType &value)
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+bool ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::deleteValue(const ElementType &value)
 {
+    typename Instrumentation::Timer timer(instrumentation, LIST_OP_DELETE_VALUE);
+
     if (first == NULL_INDEX)
     { // list is empty
         return false;
@@ -641,8 +2168,8 @@ bool ArrayBasedList<ElementType>::deleteValue(const ElementType &value)
     if (nodePool.getNodeData(first) == value)
     {
         int temp = first;
-        first = nodePool.getNextOfNode(first); // move head to next node
-        nodePool.releaseNode(temp);            // release the deleted node
+        setFirst(nodePool.getNextOfNode(first)); // move head to next node
+        releaseNode(temp);                       // release the deleted node
         return true;
     }
 
@@ -652,11 +2179,12 @@ bool ArrayBasedList<ElementType>::deleteValue(const ElementType &value)
 
     while (curr != NULL_INDEX)
     {
+        instrumentation.traversed(1);
         if (nodePool.getNodeData(curr) == value)
         {
             // Link previous node to the next of current
-            nodePool.setNextOfNode(prev, nodePool.getNextOfNode(curr));
-            nodePool.releaseNode(curr); // release node
+            link(prev, nodePool.getNextOfNode(curr));
+            releaseNode(curr); // release node
             return true;
         }
         prev = curr;
@@ -665,4 +2193,383 @@ bool ArrayBasedList<ElementType>::deleteValue(const ElementType &value)
     return false; // Value not found
 }
 
+// Definition of removeIf()
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+template <typename Predicate>
+int ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::removeIf(Predicate predicate)
+{
+    typename Instrumentation::Timer timer(instrumentation, LIST_OP_REMOVE);
+
+    int removed = 0;              // number of nodes removed
+    int visited = 0;              // number of nodes tested
+    int removedHead = NULL_INDEX; // chain of removed nodes
+    int removedTail = NULL_INDEX;
+    int prev = NULL_INDEX;        // last node kept (NULL_INDEX: none yet)
+    int curr = first;
+
+    while (curr != NULL_INDEX)
+    {
+        visited++;
+        if (!predicate(nodePool.nodeData(curr))) // keep curr
+        {
+            prev = curr;
+            curr = nodePool.getNextOfNode(curr);
+            continue;
+        }
+
+        // Extend the run of matching nodes starting at curr
+        int runTail = curr;
+        int after = nodePool.getNextOfNode(curr); // first node after the run
+        eviction.released(curr);
+        removed++;
+        while (after != NULL_INDEX)
+        {
+            visited++;
+            if (!predicate(nodePool.nodeData(after))) // 'after' is kept
+                break;
+            runTail = after;
+            after = nodePool.getNextOfNode(after);
+            eviction.released(runTail);
+            removed++;
+        }
+
+        // Unlink the run, already linked together, and add it to the chain
+        if (prev == NULL_INDEX)
+            setFirst(after);
+        else
+            link(prev, after);
+        if (removedHead == NULL_INDEX)
+            removedHead = curr;
+        else
+            nodePool.setNextOfNode(removedTail, curr);
+        removedTail = runTail;
+
+        // Continue after the kept node that ended the run
+        prev = after;
+        curr = after != NULL_INDEX ? nodePool.getNextOfNode(after) : NULL_INDEX;
+    }
+    instrumentation.traversed(visited);
+
+    if (removed > 0)
+    {
+        instrumentation.released();
+        nodePool.releaseChain(removedHead, removedTail, removed);
+    }
+    return removed;
+}
+
+// Definition of removeAll()
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+int ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::removeAll(const ElementType &value)
+{
+    return removeIf([&value](const ElementType &data) { return data == value; });
+}
+
+// Definition of erase()
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+int ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::erase(
+    const_iterator rangeBegin, const_iterator rangeEnd)
+{
+    typename Instrumentation::Timer timer(instrumentation, LIST_OP_REMOVE);
+
+    Segment removed = extract(rangeBegin, rangeEnd);
+    int count = removed.size();
+    release(removed);
+    return count;
+}
+
+// Definition of splitAt()
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+typename ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::Segment
+ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::splitAt(int position)
+{
+    Segment segment;
+    if (position < 0 || first == NULL_INDEX)
+        return segment;
+
+    // Find the node before position and cut after it
+    if (position == 0)
+    {
+        segment.head = first;
+        setFirst(NULL_INDEX);
+    }
+    else
+    {
+        int temp = first; // To traverse the list
+        int count = 1;    // Counter to stop at position - 1
+        while (nodePool.getNextOfNode(temp) != NULL_INDEX && count < position)
+        {
+            temp = nodePool.getNextOfNode(temp);
+            count++;
+        }
+        instrumentation.traversed(count);
+        if (count < position) // position not reached (list is too small)
+            return segment;
+
+        segment.head = nodePool.getNextOfNode(temp);
+        if (segment.head == NULL_INDEX) // nothing after position
+            return segment;
+        link(temp, NULL_INDEX);
+    }
+
+    // Walk the detached nodes to find the tail
+    for (int i = segment.head; i != NULL_INDEX; i = nodePool.getNextOfNode(i))
+    {
+        eviction.released(i);
+        segment.tail = i;
+        segment.length++;
+    }
+    instrumentation.traversed(segment.length);
+    return segment;
+}
+
+// Definition of extract()
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+typename ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::Segment
+ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::extract(
+    const_iterator rangeBegin, const_iterator rangeEnd)
+{
+    Segment segment;
+    int head = rangeBegin.nodeIndex(); // first node detached
+    int after = rangeEnd.nodeIndex();  // first node kept after the range
+    if (head == after) // empty range
+        return segment;
+
+    // Find the node before the range
+    int prev = NULL_INDEX;
+    if (head != first)
+    {
+        prev = first;
+        while (nodePool.getNextOfNode(prev) != head)
+        {
+            instrumentation.traversed(1);
+            prev = nodePool.getNextOfNode(prev);
+        }
+    }
+
+    // Walk the range to its last node
+    segment.head = head;
+    segment.tail = head;
+    segment.length = 1;
+    eviction.released(head);
+    while (nodePool.getNextOfNode(segment.tail) != after)
+    {
+        segment.tail = nodePool.getNextOfNode(segment.tail);
+        eviction.released(segment.tail);
+        segment.length++;
+    }
+    instrumentation.traversed(segment.length);
+
+    // Link around the range and terminate it
+    if (prev == NULL_INDEX)
+        setFirst(after);
+    else
+        link(prev, after);
+    nodePool.setNextOfNode(segment.tail, NULL_INDEX);
+    return segment;
+}
+
+// Definition of splice()
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+bool ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::splice(int position,
+                                                                          Segment &segment)
+{
+    if (position < 0)
+        return false;
+    if (segment.head == NULL_INDEX) // nothing to splice
+        return true;
+
+    if (position == 0) // segment goes at the beginning
+    {
+        link(segment.tail, first);
+        setFirst(segment.head);
+    }
+    else
+    {
+        if (first == NULL_INDEX) // Can not insert in the middle of an empty list
+            return false;
+
+        int temp = first; // To traverse the list
+        int count = 1;    // Counter to stop at position - 1
+        while (nodePool.getNextOfNode(temp) != NULL_INDEX && count < position)
+        {
+            temp = nodePool.getNextOfNode(temp);
+            count++;
+        }
+        instrumentation.traversed(count);
+        if (count < position) // position not reached (list is too small)
+            return false;
+
+        // segment goes between temp and its next
+        link(segment.tail, nodePool.getNextOfNode(temp));
+        link(temp, segment.head);
+    }
+    segment = Segment();
+    return true;
+}
+
+// Definition of merge()
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+void ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::merge(Segment &sorted)
+{
+    int a = first;         // next node of the list
+    int b = sorted.head;   // next node of the segment
+    int last = NULL_INDEX; // last node of the merged list
+    int visited = 0;       // nodes linked by the loop
+
+    while (a != NULL_INDEX && b != NULL_INDEX)
+    {
+        int chosen; // smaller node, the list's on a tie
+        if (nodePool.nodeData(a) > nodePool.nodeData(b))
+        {
+            chosen = b;
+            b = nodePool.getNextOfNode(b);
+        }
+        else
+        {
+            chosen = a;
+            a = nodePool.getNextOfNode(a);
+        }
+
+        // Only write a link when the source changes
+        if (last == NULL_INDEX)
+            setFirst(chosen);
+        else if (nodePool.getNextOfNode(last) != chosen)
+            link(last, chosen);
+        last = chosen;
+        visited++;
+    }
+    instrumentation.traversed(visited);
+
+    // Append what is left of either sequence
+    int rest = a != NULL_INDEX ? a : b;
+    if (last == NULL_INDEX)
+        setFirst(rest);
+    else if (nodePool.getNextOfNode(last) != rest)
+        link(last, rest);
+    if (rest == b && b != NULL_INDEX) // segment's tail is now the last node
+        link(sorted.tail, NULL_INDEX);
+
+    sorted = Segment();
+}
+
+// Definition of release()
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+void ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::release(Segment &segment)
+{
+    if (segment.head == NULL_INDEX) // nothing to release
+        return;
+
+    instrumentation.released();
+    nodePool.releaseChain(segment.head, segment.tail, segment.length);
+    segment = Segment();
+}
+
+// Definition of parallelForEach()
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+template <typename Function>
+void ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::parallelForEach(
+    Function function, int threadCount, int grain) const
+{
+    runOnChunks([](int) {}, [&](int, int node, int count) {
+        for (int i = 0; i < count; i++, node = nodePool.getNextOfNode(node))
+            function(nodePool.nodeData(node));
+    }, threadCount, grain);
+}
+
+// Definition of parallelTransform()
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+template <typename Function>
+void ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::parallelTransform(
+    Function function, int threadCount, int grain)
+{
+    runOnChunks([](int) {}, [&](int, int node, int count) {
+        for (int i = 0; i < count; i++, node = nodePool.getNextOfNode(node))
+        {
+            ElementType &slot = nodePool.nodeData(node); // written in place
+            slot = function(static_cast<const ElementType &>(slot));
+        }
+    }, threadCount, grain);
+}
+
+// Definition of parallelReduce()
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+template <typename T, typename FoldOperation, typename CombineOperation>
+T ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::parallelReduce(
+    T identity, FoldOperation fold, CombineOperation combine, int threadCount,
+    int grain) const
+{
+    // One partial result per chunk, each filled by the chunk's own thread
+    vector<T> partials;
+    runOnChunks([&](int chunkCount) { partials.assign(chunkCount, identity); },
+                [&](int chunk, int node, int count) {
+        T result = identity;
+        for (int i = 0; i < count; i++, node = nodePool.getNextOfNode(node))
+            result = fold(result, nodePool.nodeData(node));
+        partials[chunk] = result;
+    }, threadCount, grain);
+
+    // Combine in chain order
+    T result = identity;
+    for (size_t chunk = 0; chunk < partials.size(); chunk++)
+        result = combine(result, partials[chunk]);
+    return result;
+}
+
+// Definition of chunkMarks()
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+vector<int> ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::chunkMarks(
+    int grain, int &length) const
+{
+    vector<int> marks;
+    length = 0;
+    for (int node = first; node != NULL_INDEX; node = nodePool.getNextOfNode(node))
+    {
+        if (length % grain == 0)
+            marks.push_back(node);
+        length++;
+    }
+    instrumentation.traversed(length);
+    return marks;
+}
+
+// Definition of runOnChunks()
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+template <typename Prepare, typename ChunkTask>
+void ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::runOnChunks(
+    Prepare prepare, ChunkTask task, int threadCount, int grain) const
+{
+    if (threadCount <= 0)
+        threadCount = defaultThreadCount();
+    if (grain < 1)
+        grain = 1;
+
+    int length;
+    vector<int> marks = chunkMarks(grain, length);
+    int markCount = (int)marks.size();
+    int chunkCount = chunkCountFor(markCount, threadCount);
+    prepare(chunkCount);
+
+    runChunks(chunkCount, threadCount, [&](int chunk) {
+        // Chunk 'chunk' starts at mark lo and ends before mark hi (or at the end)
+        int lo = (int)((long long)markCount * chunk / chunkCount);
+        int hi = (int)((long long)markCount * (chunk + 1) / chunkCount);
+        long long end = hi == markCount ? length : (long long)hi * grain;
+        task(chunk, marks[lo], (int)(end - (long long)lo * grain));
+    });
+}
+
 #endif
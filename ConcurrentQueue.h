@@ -0,0 +1,418 @@
+/*-- ConcurrentQueue.h ---------------------------------------------------------
+    This header file defines two bounded FIFO queues for passing elements
+    between threads, built on a NodePool:
+        SpscQueue: one producer thread and one consumer thread; enqueue and
+                   dequeue are wait-free (a bounded number of steps each).
+        MpscQueue: any number of producer threads and one consumer thread;
+                   enqueue is lock-free (a producer only retries when another
+                   one claimed the same cell first) and dequeue is wait-free.
+
+    The elements live in the queue's NodePool. The constructor acquires every
+    node of the fresh pool as one chain, which is nodes 0, 1,...,
+    Capacity - 1 in order, and uses it as a ring: the element at queue
+    position p (positions count every enqueue ever made) is in node
+    p % Capacity. Enqueue writes the tail node and dequeue reads the head
+    node, both O(1); nodes are reused in ring order, so nothing is allocated
+    after construction (except by the element type itself). The pool's
+    Capacity is the bound of the queue: enqueue returns false while the
+    queue is full, which is the backpressure on producers.
+
+    Basic operations are:
+        Constructor: Constructs an empty queue.
+        enqueue: Add an element at the tail (producer side).
+        dequeue: Remove the element at the head (consumer side).
+        dequeueBatch: Remove up to a number of elements at once (consumer).
+        size: Returns the number of elements (a snapshot).
+        isEmpty: Check if the queue is empty (a snapshot).
+        capacity: Returns the bound of the queue.
+
+    The head and tail counters are on separate cache lines, so producers
+    and the consumer do not share a line for their own counter. The queues
+    can not be copied. Programs must be linked with -pthread.
+
+    Class Invariant:
+        1. head <= tail <= head + Capacity; the queue holds the elements at
+           positions head..tail - 1.
+        2. (MpscQueue) The cell of position p has sequence p when it is free
+           for that position, p + 1 once the element of position p is
+           stored, and p + Capacity once it has been dequeued; these must
+           differ, so an MpscQueue has a Capacity of at least 2.
+------------------------------------------------------------------------------*/
+
+#ifndef CONCURRENTQUEUE_H
+#define CONCURRENTQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include "NodePool.h"
+
+using namespace std;
+
+const size_t CACHE_LINE = 64; // bytes; counters written by different threads are apart
+
+template <typename ElementType, int Capacity = CAPACITY>
+class SpscQueue
+{
+    static_assert(Capacity != GROWABLE, "SpscQueue is bounded by a fixed Capacity");
+
+public:
+    /******** Member Functions ********/
+
+    /***** Class constructor *****/
+    SpscQueue();
+    /*--------------------------------------------------------------------------
+        Construct an empty SpscQueue.
+
+        Precondition:  None.
+        Postcondition: Every node of the pool belongs to the queue's ring and
+                       the queue is empty.
+    --------------------------------------------------------------------------*/
+
+    SpscQueue(const SpscQueue &) = delete;
+    SpscQueue &operator=(const SpscQueue &) = delete;
+
+    bool enqueue(const ElementType &value);
+    /*--------------------------------------------------------------------------
+        Add an element at the tail of the queue.
+
+        Precondition:  Only called by the producer thread.
+        Postcondition: value is copied into the tail node and published to
+                       the consumer, and true is returned; false if the
+                       queue is full. Wait-free.
+    --------------------------------------------------------------------------*/
+
+    bool dequeue(ElementType &value);
+    /*--------------------------------------------------------------------------
+        Remove the element at the head of the queue.
+
+        Precondition:  Only called by the consumer thread.
+        Postcondition: The head element is moved into value, its node goes
+                       back to the producer, and true is returned; false if
+                       the queue is empty. Wait-free.
+    --------------------------------------------------------------------------*/
+
+    template <typename OutputIterator>
+    int dequeueBatch(OutputIterator out, int maxCount);
+    /*--------------------------------------------------------------------------
+        Remove up to maxCount elements from the head of the queue.
+
+        Precondition:  Only called by the consumer thread; out can receive
+                       maxCount elements.
+        Postcondition: The elements available, up to maxCount, are moved to
+                       out in FIFO order, with one read of the tail and one
+                       release of their nodes for the whole batch. Returns
+                       the number of elements removed.
+    --------------------------------------------------------------------------*/
+
+    int size() const;
+    /*--------------------------------------------------------------------------
+        Returns the number of elements in the queue, in O(1); exact only when
+        neither thread is running an operation.
+    --------------------------------------------------------------------------*/
+
+    bool isEmpty() const;
+    /*--------------------------------------------------------------------------
+        Check if the queue is empty, with the same accuracy as size().
+    --------------------------------------------------------------------------*/
+
+    int capacity() const;
+    /*--------------------------------------------------------------------------
+        Returns Capacity, the largest number of elements the queue holds.
+    --------------------------------------------------------------------------*/
+
+private:
+    NodePool<ElementType, Capacity> pool; // elements, one node per ring slot
+
+    alignas(CACHE_LINE) atomic<size_t> head; // next position to dequeue (consumer)
+    size_t tailSeen;                         // consumer's last read of tail
+
+    alignas(CACHE_LINE) atomic<size_t> tail; // next position to enqueue (producer)
+    size_t headSeen;                         // producer's last read of head
+
+}; // end of class declaration
+
+template <typename ElementType, int Capacity = CAPACITY>
+class MpscQueue
+{
+    static_assert(Capacity != GROWABLE, "MpscQueue is bounded by a fixed Capacity");
+    // With one cell, a stored element (sequence p + 1) would look free for
+    // position p + 1 and be overwritten
+    static_assert(Capacity >= 2, "MpscQueue needs a Capacity of at least 2");
+
+public:
+    /******** Member Functions ********/
+
+    /***** Class constructor *****/
+    MpscQueue();
+    /*--------------------------------------------------------------------------
+        Construct an empty MpscQueue.
+
+        Precondition:  None.
+        Postcondition: Every node of the pool belongs to the queue's ring,
+                       cell i has sequence i, and the queue is empty.
+    --------------------------------------------------------------------------*/
+
+    MpscQueue(const MpscQueue &) = delete;
+    MpscQueue &operator=(const MpscQueue &) = delete;
+
+    bool enqueue(const ElementType &value);
+    /*--------------------------------------------------------------------------
+        Add an element at the tail of the queue.
+
+        Precondition:  None (any thread may call it).
+        Postcondition: The tail position is claimed with one compare-and-swap
+                       (retried only if another producer claimed it first),
+                       value is copied into its cell and published, and true
+                       is returned; false if the queue is full.
+    --------------------------------------------------------------------------*/
+
+    bool dequeue(ElementType &value);
+    /*--------------------------------------------------------------------------
+        Remove the element at the head of the queue.
+
+        Precondition:  Only called by the consumer thread.
+        Postcondition: The head element is moved into value, its cell is
+                       handed back to the producers, and true is returned;
+                       false if the queue is empty, or if the producer that
+                       claimed the head position has not published its
+                       element yet.
+    --------------------------------------------------------------------------*/
+
+    template <typename OutputIterator>
+    int dequeueBatch(OutputIterator out, int maxCount);
+    /*--------------------------------------------------------------------------
+        Remove up to maxCount elements from the head of the queue.
+
+        Precondition:  Only called by the consumer thread; out can receive
+                       maxCount elements.
+        Postcondition: The published elements at the head, up to maxCount,
+                       are moved to out in FIFO order, and head is advanced
+                       once for the whole batch. Returns the number of
+                       elements removed.
+    --------------------------------------------------------------------------*/
+
+    int size() const;
+    /*--------------------------------------------------------------------------
+        Returns the number of positions claimed and not yet dequeued, in
+        O(1); exact only when no thread is running an operation.
+    --------------------------------------------------------------------------*/
+
+    bool isEmpty() const;
+    /*--------------------------------------------------------------------------
+        Check if the queue is empty, with the same accuracy as size().
+    --------------------------------------------------------------------------*/
+
+    int capacity() const;
+    /*--------------------------------------------------------------------------
+        Returns Capacity, the largest number of elements the queue holds.
+    --------------------------------------------------------------------------*/
+
+private:
+    /** Private class Cell: data of a pool node */
+    class Cell
+    {
+    public:
+        atomic<size_t> sequence; // position the cell is ready for (see invariant)
+        ElementType value;       // element stored
+    };
+
+    NodePool<Cell, Capacity> pool; // cells, one node per ring slot
+
+    alignas(CACHE_LINE) atomic<size_t> head; // next position to dequeue (consumer)
+
+    alignas(CACHE_LINE) atomic<size_t> tail; // next position to claim (producers)
+
+}; // end of class declaration
+
+/**************** FUNCTION DEFINITIONS ****************************************/
+
+// Definition of SpscQueue constructor
+template <typename ElementType, int Capacity>
+SpscQueue<ElementType, Capacity>::SpscQueue()
+    : head(0), tailSeen(0), tail(0), headSeen(0)
+{
+    // Take every node as one chain (nodes 0..Capacity - 1 of a fresh pool)
+    int last;
+    pool.acquireChain(Capacity, last);
+}
+
+// Definition of SpscQueue enqueue()
+template <typename ElementType, int Capacity>
+bool SpscQueue<ElementType, Capacity>::enqueue(const ElementType &value)
+{
+    size_t position = tail.load(memory_order_relaxed);
+    if (position - headSeen == (size_t)Capacity) // full when last looked
+    {
+        headSeen = head.load(memory_order_acquire);
+        if (position - headSeen == (size_t)Capacity)
+            return false; // still full
+    }
+
+    pool.nodeData((int)(position % Capacity)) = value;
+    tail.store(position + 1, memory_order_release); // publish the element
+    return true;
+}
+
+// Definition of SpscQueue dequeue()
+template <typename ElementType, int Capacity>
+bool SpscQueue<ElementType, Capacity>::dequeue(ElementType &value)
+{
+    size_t position = head.load(memory_order_relaxed);
+    if (position == tailSeen) // empty when last looked
+    {
+        tailSeen = tail.load(memory_order_acquire);
+        if (position == tailSeen)
+            return false; // still empty
+    }
+
+    value = move(pool.nodeData((int)(position % Capacity)));
+    head.store(position + 1, memory_order_release); // give the node back
+    return true;
+}
+
+// Definition of SpscQueue dequeueBatch()
+template <typename ElementType, int Capacity>
+template <typename OutputIterator>
+int SpscQueue<ElementType, Capacity>::dequeueBatch(OutputIterator out, int maxCount)
+{
+    size_t position = head.load(memory_order_relaxed);
+    tailSeen = tail.load(memory_order_acquire);
+    size_t available = tailSeen - position;
+    int count = available < (size_t)maxCount ? (int)available : maxCount;
+    if (count <= 0)
+        return 0;
+
+    for (int i = 0; i < count; i++)
+        *out++ = move(pool.nodeData((int)((position + i) % Capacity)));
+    head.store(position + count, memory_order_release); // give the nodes back
+    return count;
+}
+
+// Definition of SpscQueue size()
+template <typename ElementType, int Capacity>
+int SpscQueue<ElementType, Capacity>::size() const
+{
+    size_t first = head.load(memory_order_acquire); // head first: usually not past tail
+    ptrdiff_t count = (ptrdiff_t)(tail.load(memory_order_acquire) - first);
+    return count < 0 ? 0 : (count > Capacity ? Capacity : (int)count);
+}
+
+// Definition of SpscQueue isEmpty()
+template <typename ElementType, int Capacity>
+bool SpscQueue<ElementType, Capacity>::isEmpty() const
+{
+    return size() == 0;
+}
+
+// Definition of SpscQueue capacity()
+template <typename ElementType, int Capacity>
+int SpscQueue<ElementType, Capacity>::capacity() const
+{
+    return Capacity;
+}
+
+// Definition of MpscQueue constructor
+template <typename ElementType, int Capacity>
+MpscQueue<ElementType, Capacity>::MpscQueue()
+    : head(0), tail(0)
+{
+    // Take every node as one chain (nodes 0..Capacity - 1 of a fresh pool)
+    int last;
+    pool.acquireChain(Capacity, last);
+    for (int i = 0; i < Capacity; i++)
+        pool.nodeData(i).sequence.store(i, memory_order_relaxed);
+}
+
+// Definition of MpscQueue enqueue()
+template <typename ElementType, int Capacity>
+bool MpscQueue<ElementType, Capacity>::enqueue(const ElementType &value)
+{
+    size_t position = tail.load(memory_order_relaxed);
+    Cell *cell;
+    for (;;)
+    {
+        cell = &pool.nodeData((int)(position % Capacity));
+        ptrdiff_t lag = (ptrdiff_t)(cell->sequence.load(memory_order_acquire) - position);
+        if (lag == 0) // free for this position: claim it
+        {
+            if (tail.compare_exchange_weak(position, position + 1, memory_order_relaxed))
+                break;
+            // position now holds the current tail; try again
+        }
+        else if (lag < 0) // not yet dequeued a lap ago: full
+        {
+            return false;
+        }
+        else // another producer claimed it; catch up with tail
+        {
+            position = tail.load(memory_order_relaxed);
+        }
+    }
+
+    cell->value = value;
+    cell->sequence.store(position + 1, memory_order_release); // publish
+    return true;
+}
+
+// Definition of MpscQueue dequeue()
+template <typename ElementType, int Capacity>
+bool MpscQueue<ElementType, Capacity>::dequeue(ElementType &value)
+{
+    size_t position = head.load(memory_order_relaxed);
+    Cell &cell = pool.nodeData((int)(position % Capacity));
+    if (cell.sequence.load(memory_order_acquire) != position + 1)
+        return false; // empty, or not yet published
+
+    value = move(cell.value);
+    cell.sequence.store(position + Capacity, memory_order_release); // free for next lap
+    head.store(position + 1, memory_order_relaxed);
+    return true;
+}
+
+// Definition of MpscQueue dequeueBatch()
+template <typename ElementType, int Capacity>
+template <typename OutputIterator>
+int MpscQueue<ElementType, Capacity>::dequeueBatch(OutputIterator out, int maxCount)
+{
+    size_t position = head.load(memory_order_relaxed);
+    int count = 0;
+    while (count < maxCount)
+    {
+        Cell &cell = pool.nodeData((int)(position % Capacity));
+        if (cell.sequence.load(memory_order_acquire) != position + 1)
+            break; // no more published elements
+
+        *out++ = move(cell.value);
+        cell.sequence.store(position + Capacity, memory_order_release);
+        position++;
+        count++;
+    }
+    head.store(position, memory_order_relaxed);
+    return count;
+}
+
+// Definition of MpscQueue size()
+template <typename ElementType, int Capacity>
+int MpscQueue<ElementType, Capacity>::size() const
+{
+    size_t first = head.load(memory_order_acquire); // head first: usually not past tail
+    ptrdiff_t count = (ptrdiff_t)(tail.load(memory_order_acquire) - first);
+    return count < 0 ? 0 : (count > Capacity ? Capacity : (int)count);
+}
+
+// Definition of MpscQueue isEmpty()
+template <typename ElementType, int Capacity>
+bool MpscQueue<ElementType, Capacity>::isEmpty() const
+{
+    return size() == 0;
+}
+
+// Definition of MpscQueue capacity()
+template <typename ElementType, int Capacity>
+int MpscQueue<ElementType, Capacity>::capacity() const
+{
+    return Capacity;
+}
+
+#endif
@@ -0,0 +1,385 @@
+/*-- HugePageResource.h --------------------------------------------------------
+    This header file defines HugePageResource, a std::pmr::memory_resource
+    that maps its memory directly with mmap, on huge pages and on chosen
+    NUMA nodes, and NumaNodeResources, one such resource per NUMA node.
+
+    Walking a list of 10^7+ nodes whose 'next' links jump around the pool
+    misses the TLB on almost every node with 4 KB pages; a 2 MB page covers
+    512 times more nodes. Placement is chosen per resource:
+        HUGE_PAGES_NONE:        4 KB pages (madvise(MADV_NOHUGEPAGE)).
+        HUGE_PAGES_TRANSPARENT: transparent huge pages: a 2 MB aligned
+                                mapping with madvise(MADV_HUGEPAGE).
+        HUGE_PAGES_EXPLICIT:    pages of the hugetlbfs pool (MAP_HUGETLB),
+                                falling back to transparent huge pages when
+                                the pool is empty or not configured.
+    and the NUMA policy:
+        NUMA_DEFAULT:    the kernel's (first touch).
+        NUMA_BIND:       only on the given node.
+        NUMA_INTERLEAVE: pages spread round-robin over every node.
+    The policy is set with the mbind system call (no libnuma needed); if the
+    kernel has no NUMA support the memory is used with the default policy.
+
+    Every allocation is its own mapping, rounded up to a whole huge page, so
+    the resource is meant for a few large blocks: a fixed list placed in it
+    (placement new on allocate(sizeof(list))), or as the upstream of a
+    pmr::monotonic_buffer_resource or pmr::unsynchronized_pool_resource
+    serving the chunks of growable pools.
+
+    Basic operations are:
+        Constructor: Constructs a resource with a placement.
+        allocate / deallocate: (std::pmr::memory_resource) Map or unmap
+                               memory.
+        fallbackCount: Explicit huge page mappings that fell back.
+        numaFailureCount: Mappings whose NUMA policy could not be set.
+        currentNumaNode: NUMA node of the calling thread.
+        numaNodeCount: Number of NUMA nodes of the machine.
+        NumaNodeResources: One resource bound to each NUMA node, for lists
+                           used by threads running on that node.
+------------------------------------------------------------------------------*/
+
+#ifndef HUGEPAGERESOURCE_H
+#define HUGEPAGERESOURCE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <vector>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+using namespace std;
+
+const size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024; // size of a (x86-64 / arm64) huge page
+const int MPOL_BIND_MODE = 2;                  // MPOL_BIND of <linux/mempolicy.h>
+const int MPOL_INTERLEAVE_MODE = 3;            // MPOL_INTERLEAVE
+const int MAX_NUMA_NODES = 64;                 // nodes in one mbind node mask
+
+/** Page size of a HugePageResource */
+enum HugePageMode
+{
+    HUGE_PAGES_NONE,
+    HUGE_PAGES_TRANSPARENT,
+    HUGE_PAGES_EXPLICIT
+};
+
+/** NUMA placement of a HugePageResource */
+enum NumaPolicy
+{
+    NUMA_DEFAULT,
+    NUMA_BIND,
+    NUMA_INTERLEAVE
+};
+
+int currentNumaNode();
+/*------------------------------------------------------------------------------
+    Get the NUMA node of the CPU the calling thread runs on.
+
+    Precondition:  None.
+    Postcondition: Returns the node (getcpu), or 0 if it is unknown.
+------------------------------------------------------------------------------*/
+
+int numaNodeCount();
+/*------------------------------------------------------------------------------
+    Get the number of NUMA nodes.
+
+    Precondition:  None.
+    Postcondition: Returns 1 + the highest node listed in
+                   /sys/devices/system/node/possible (at most
+                   MAX_NUMA_NODES), or 1 if it can not be read.
+------------------------------------------------------------------------------*/
+
+class HugePageResource : public pmr::memory_resource
+{
+public:
+    /******** Member Functions ********/
+
+    /***** Class constructor *****/
+    explicit HugePageResource(HugePageMode mode = HUGE_PAGES_TRANSPARENT,
+                              NumaPolicy policy = NUMA_DEFAULT, int node = 0);
+    /*--------------------------------------------------------------------------
+        Construct a HugePageResource.
+
+        Precondition:  0 <= node < MAX_NUMA_NODES (used by NUMA_BIND only).
+        Postcondition: Memory will be mapped with the given page size and
+                       NUMA policy.
+    --------------------------------------------------------------------------*/
+
+    HugePageMode mode() const;
+    NumaPolicy policy() const;
+    int node() const;
+    /*--------------------------------------------------------------------------
+        Get the placement requested at construction.
+    --------------------------------------------------------------------------*/
+
+    int fallbackCount() const;
+    /*--------------------------------------------------------------------------
+        Get the number of HUGE_PAGES_EXPLICIT mappings that fell back to
+        transparent huge pages.
+    --------------------------------------------------------------------------*/
+
+    int numaFailureCount() const;
+    /*--------------------------------------------------------------------------
+        Get the number of mappings whose NUMA policy could not be set (no
+        NUMA support, or no such node).
+    --------------------------------------------------------------------------*/
+
+protected:
+    void *do_allocate(size_t bytes, size_t alignment) override;
+    /*--------------------------------------------------------------------------
+        Map memory.
+
+        Precondition:  alignment <= HUGE_PAGE_SIZE.
+        Postcondition: Returns a new mapping of 'bytes' rounded up to a
+                       whole huge page, aligned on HUGE_PAGE_SIZE, placed as
+                       requested, not yet touched (pages are zero). Throws
+                       bad_alloc if mmap fails.
+    --------------------------------------------------------------------------*/
+
+    void do_deallocate(void *pointer, size_t bytes, size_t alignment) override;
+    /*--------------------------------------------------------------------------
+        Unmap memory obtained from allocate(bytes, alignment).
+    --------------------------------------------------------------------------*/
+
+    bool do_is_equal(const pmr::memory_resource &other) const noexcept override;
+    /*--------------------------------------------------------------------------
+        Returns true only for this very resource.
+    --------------------------------------------------------------------------*/
+
+private:
+    void *mapAligned(size_t length);
+    /*--------------------------------------------------------------------------
+        Map 'length' bytes of anonymous memory aligned on HUGE_PAGE_SIZE, or
+        return MAP_FAILED.
+    --------------------------------------------------------------------------*/
+
+    HugePageMode pageMode; // page size requested
+    NumaPolicy numaPolicy; // NUMA placement requested
+    int numaNode;          // node of NUMA_BIND
+    int fallbacks;         // explicit mappings that fell back
+    int numaFailures;      // mappings whose mbind failed
+};
+
+class NumaNodeResources
+{
+public:
+    /******** Member Functions ********/
+
+    /***** Class constructor *****/
+    explicit NumaNodeResources(HugePageMode mode = HUGE_PAGES_TRANSPARENT);
+    /*--------------------------------------------------------------------------
+        Construct one HugePageResource per NUMA node.
+
+        Precondition:  None.
+        Postcondition: Resource i maps memory with 'mode', bound to node i.
+    --------------------------------------------------------------------------*/
+
+    HugePageResource &forNode(int node);
+    /*--------------------------------------------------------------------------
+        Get the resource bound to a node.
+
+        Precondition:  0 <= node < count().
+        Postcondition: Returns it.
+    --------------------------------------------------------------------------*/
+
+    HugePageResource &local();
+    /*--------------------------------------------------------------------------
+        Get the resource bound to the node of the calling thread, for the
+        pools of lists used by threads pinned to that node.
+    --------------------------------------------------------------------------*/
+
+    int count() const;
+    /*--------------------------------------------------------------------------
+        Get the number of resources (NUMA nodes).
+    --------------------------------------------------------------------------*/
+
+private:
+    vector<unique_ptr<HugePageResource>> resources; // one per node (they never move)
+};
+
+/**************** FUNCTION DEFINITIONS ****************************************/
+
+// Definition of currentNumaNode()
+inline int currentNumaNode()
+{
+#ifdef SYS_getcpu
+    unsigned cpu = 0, node = 0;
+    if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0)
+        return (int)node;
+#endif
+    return 0;
+}
+
+// Definition of numaNodeCount()
+inline int numaNodeCount()
+{
+    FILE *file = fopen("/sys/devices/system/node/possible", "r");
+    if (file == nullptr)
+        return 1;
+
+    // Format is a range list such as "0" or "0-3"; the last number is the
+    // highest node
+    int highest = 0, number;
+    while (fscanf(file, "%d", &number) == 1)
+    {
+        highest = number;
+        if (fgetc(file) == EOF)
+            break;
+    }
+    fclose(file);
+    return highest + 1 < MAX_NUMA_NODES ? highest + 1 : MAX_NUMA_NODES;
+}
+
+// Definition of HugePageResource constructor
+inline HugePageResource::HugePageResource(HugePageMode mode, NumaPolicy policy, int node)
+    : pageMode(mode), numaPolicy(policy), numaNode(node), fallbacks(0),
+      numaFailures(0) {}
+
+// Definition of mode()
+inline HugePageMode HugePageResource::mode() const
+{
+    return pageMode;
+}
+
+// Definition of policy()
+inline NumaPolicy HugePageResource::policy() const
+{
+    return numaPolicy;
+}
+
+// Definition of node()
+inline int HugePageResource::node() const
+{
+    return numaNode;
+}
+
+// Definition of fallbackCount()
+inline int HugePageResource::fallbackCount() const
+{
+    return fallbacks;
+}
+
+// Definition of numaFailureCount()
+inline int HugePageResource::numaFailureCount() const
+{
+    return numaFailures;
+}
+
+// Definition of do_allocate()
+inline void *HugePageResource::do_allocate(size_t bytes, size_t alignment)
+{
+    if (alignment > HUGE_PAGE_SIZE)
+        throw bad_alloc();
+    size_t length = (bytes + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+    if (length == 0)
+        length = HUGE_PAGE_SIZE;
+
+    void *address = MAP_FAILED;
+#ifdef MAP_HUGETLB
+    if (pageMode == HUGE_PAGES_EXPLICIT) // from the hugetlbfs pool
+    {
+        address = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (address == MAP_FAILED)
+            fallbacks++;
+    }
+#endif
+    if (address == MAP_FAILED)
+    {
+        address = mapAligned(length);
+        if (address == MAP_FAILED)
+            throw bad_alloc();
+#ifdef MADV_HUGEPAGE
+        if (pageMode == HUGE_PAGES_NONE)
+            madvise(address, length, MADV_NOHUGEPAGE);
+        else
+            madvise(address, length, MADV_HUGEPAGE);
+#endif
+    }
+
+    // Set the NUMA policy before any page is touched
+    if (numaPolicy != NUMA_DEFAULT)
+    {
+        bool applied = false;
+#ifdef SYS_mbind
+        unsigned long mask = 0; // one bit per node
+        if (numaPolicy == NUMA_BIND)
+            mask = 1ul << numaNode;
+        else
+            mask = numaNodeCount() == MAX_NUMA_NODES ? ~0ul
+                                                     : (1ul << numaNodeCount()) - 1;
+        int mode = numaPolicy == NUMA_BIND ? MPOL_BIND_MODE : MPOL_INTERLEAVE_MODE;
+        applied = syscall(SYS_mbind, address, length, mode, &mask,
+                          (unsigned long)MAX_NUMA_NODES + 1, 0) == 0;
+#endif
+        if (!applied)
+            numaFailures++;
+    }
+    return address;
+}
+
+// Definition of do_deallocate()
+inline void HugePageResource::do_deallocate(void *pointer, size_t bytes, size_t)
+{
+    size_t length = (bytes + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+    munmap(pointer, length == 0 ? HUGE_PAGE_SIZE : length);
+}
+
+// Definition of do_is_equal()
+inline bool HugePageResource::do_is_equal(const pmr::memory_resource &other) const noexcept
+{
+    return this == &other;
+}
+
+// Definition of mapAligned()
+inline void *HugePageResource::mapAligned(size_t length)
+{
+    // Map one huge page more than needed, then unmap the unaligned head and
+    // the rest of the tail
+    size_t padded = length + HUGE_PAGE_SIZE;
+    void *mapping = mmap(nullptr, padded, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapping == MAP_FAILED)
+        return MAP_FAILED;
+
+    char *start = static_cast<char *>(mapping);
+    char *aligned = reinterpret_cast<char *>(
+        (reinterpret_cast<uintptr_t>(start) + HUGE_PAGE_SIZE - 1) & ~(uintptr_t)(HUGE_PAGE_SIZE - 1));
+    if (aligned > start)
+        munmap(start, aligned - start);
+    size_t tail = (start + padded) - (aligned + length);
+    if (tail > 0)
+        munmap(aligned + length, tail);
+    return aligned;
+}
+
+// Definition of NumaNodeResources constructor
+inline NumaNodeResources::NumaNodeResources(HugePageMode mode)
+{
+    int nodes = numaNodeCount();
+    for (int node = 0; node < nodes; node++)
+        resources.emplace_back(new HugePageResource(mode, NUMA_BIND, node));
+}
+
+// Definition of forNode()
+inline HugePageResource &NumaNodeResources::forNode(int node)
+{
+    return *resources[node];
+}
+
+// Definition of local()
+inline HugePageResource &NumaNodeResources::local()
+{
+    return *resources[currentNumaNode() % count()];
+}
+
+// Definition of count()
+inline int NumaNodeResources::count() const
+{
+    return (int)resources.size();
+}
+
+#endif
@@ -0,0 +1,848 @@
+/*-- JournaledList.h -----------------------------------------------------------
+    This header file defines the template class JournaledList, which makes the
+    mutations of an ArrayBasedList durable with a write-ahead journal.
+
+    The list itself lives in memory. Every successful mutation appends a
+    compact binary record to the journal file. Records are group committed:
+    they are buffered and written with a single fsync once syncBatch records
+    are pending (or when commit() is called). checkpoint() writes the whole
+    list to the checkpoint file, in the PersistentList file format, and then
+    truncates the journal. open() loads the last checkpoint and replays the
+    journal on top of it.
+
+    Every checkpoint starts a new generation. The checkpoint stores its
+    generation after the ListImageHeader, and the journal starts with a
+    JournalHeader stamped with the generation of its records (written with
+    the first commit after a checkpoint). A crash after the new checkpoint
+    is renamed in but before the journal is truncated leaves a journal of
+    an older generation, whose records the checkpoint already holds: open()
+    discards it instead of replaying it.
+
+    Journal layout (little endian, as written by the host): a JournalHeader,
+    then records of the form:
+        op:       1 byte  (one of the JournalOp values)
+        forced:   1 byte  (forced flag of insertions, 0 otherwise)
+        position: int32   (only for insertAtPosition and deleteAtPosition)
+        value:    ElementType (only for operations that take a value)
+        target:   ElementType (only for operations that take a target)
+        checksum: uint32  (FNV-1a of all the previous bytes of the record)
+
+    A record that is cut short or fails its checksum marks the end of the
+    journal (the tail of a write interrupted by a crash) and is discarded.
+    Records that were not committed when the process died are lost; a crash
+    can never leave a partially applied operation.
+
+    Mutations return the result of the list operation: true means the list
+    changed in memory. Whether the change is durable is reported separately:
+    failed() is true from a commit that could not write or sync the journal
+    (a failed write is rolled back to the last durable end of the journal,
+    and its records stay pending) until a later commit() succeeds.
+
+    Basic operations are:
+        Constructor: Constructs a JournaledList with no files open.
+        Destructor: Commits pending records and closes the files.
+        open: Load the checkpoint and replay the journal.
+        close: Commit pending records and close the files.
+        failed: Check if records are pending after a failed commit.
+        insertAtPosition, insertAfterValue, insertBeforeValue,
+        deleteAtPosition, deleteAfterValue, deleteBeforeValue, deleteValue,
+        sort: Apply the ArrayBasedList operation and journal it.
+        commit: Write and fsync all pending records.
+        checkpoint: Save the list and truncate the journal.
+        list: Read-only access to the list.
+------------------------------------------------------------------------------*/
+
+#ifndef JOURNALEDLIST_H
+#define JOURNALEDLIST_H
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "ArrayBasedList.h"
+#include "PersistentList.h"
+
+using namespace std;
+
+/** Operation codes stored in journal records */
+enum JournalOp
+{
+    JOURNAL_INSERT_AT_POSITION = 1,
+    JOURNAL_INSERT_AFTER_VALUE = 2,
+    JOURNAL_INSERT_BEFORE_VALUE = 3,
+    JOURNAL_DELETE_AT_POSITION = 4,
+    JOURNAL_DELETE_AFTER_VALUE = 5,
+    JOURNAL_DELETE_BEFORE_VALUE = 6,
+    JOURNAL_DELETE_VALUE = 7,
+    JOURNAL_SORT = 8
+};
+
+const char JOURNAL_MAGIC[8] = {'L', 'I', 'S', 'T', 'J', 'N', 'L', '1'};
+
+/** Header at the start of a journal file */
+struct JournalHeader
+{
+    char magic[8];       // JOURNAL_MAGIC
+    uint64_t generation; // generation of the checkpoint the records follow
+};
+
+/** Header of a checkpoint file, padded to LIST_IMAGE_OFFSET */
+struct CheckpointHeader
+{
+    ListImageHeader image; // describes the list image
+    uint64_t generation;   // generation started by this checkpoint
+};
+
+static_assert(sizeof(CheckpointHeader) <= LIST_IMAGE_OFFSET,
+              "CheckpointHeader must fit before the list image");
+
+template <typename ElementType, int Capacity = CAPACITY>
+class JournaledList
+{
+    static_assert(is_trivially_copyable<ElementType>::value,
+                  "JournaledList requires a trivially copyable ElementType");
+
+public:
+    typedef ArrayBasedList<ElementType, Capacity> ListType;
+
+    /******** Member Functions ********/
+
+    /***** Class constructor *****/
+    JournaledList();
+    /*--------------------------------------------------------------------------
+        Construct a JournaledList with no files open.
+
+        Precondition:  None.
+        Postcondition: The list is empty; mutations are not journaled until
+                       open() succeeds.
+    --------------------------------------------------------------------------*/
+
+    /***** Class destructor *****/
+    ~JournaledList();
+    /*--------------------------------------------------------------------------
+        Commit pending records and close the files.
+
+        Precondition:  None.
+        Postcondition: Pending records are written and synced if possible;
+                       call close() first to learn whether that worked.
+    --------------------------------------------------------------------------*/
+
+    JournaledList(const JournaledList &) = delete;
+    JournaledList &operator=(const JournaledList &) = delete;
+
+    bool open(const char *checkpointPath, const char *journalPath,
+              int syncBatch = 1);
+    /*--------------------------------------------------------------------------
+        Recover the list from its checkpoint and journal.
+
+        Precondition:  No files are open; syncBatch >= 1.
+        Postcondition: The list holds the last checkpoint (empty if there is
+                       none) with every complete journal record replayed on
+                       top of it. A torn record at the end of the journal is
+                       truncated away, and so is a journal of an older
+                       generation than the checkpoint. Records are synced
+                       once syncBatch of them are pending. Returns true on
+                       success, false if a file can not be opened, the
+                       checkpoint is invalid or the journal is newer than it.
+    --------------------------------------------------------------------------*/
+
+    bool close();
+    /*--------------------------------------------------------------------------
+        Commit pending records and close the files.
+
+        Precondition:  None.
+        Postcondition: Files are closed; the list keeps its contents. Returns
+                       false if pending records could not be committed (they
+                       are lost), true otherwise.
+    --------------------------------------------------------------------------*/
+
+    bool failed() const;
+    /*--------------------------------------------------------------------------
+        Check if the last commit failed.
+
+        Precondition:  None.
+        Postcondition: Returns true if a commit (explicit, or made by a
+                       mutation filling its batch) failed and no commit has
+                       succeeded since, so changes applied to the list may
+                       not be in the journal yet.
+    --------------------------------------------------------------------------*/
+
+    bool insertAtPosition(const ElementType &value, int position,
+                          bool forced = false);
+    bool insertAfterValue(const ElementType &value, const ElementType &target,
+                          bool forced);
+    bool insertBeforeValue(const ElementType &value, const ElementType &target,
+                           bool forced);
+    bool deleteAtPosition(int position);
+    bool deleteAfterValue(const ElementType &target);
+    bool deleteBeforeValue(const ElementType &target);
+    bool deleteValue(const ElementType &value);
+    void sort();
+    /*--------------------------------------------------------------------------
+        Apply the ArrayBasedList operation of the same name and journal it.
+
+        Precondition:  Same as the ArrayBasedList operation.
+        Postcondition: Same result as the ArrayBasedList operation. If the
+                       operation changed the list, a record is appended to the
+                       journal buffer (and committed if the batch is full; if
+                       that commit fails, the change stays applied and
+                       failed() becomes true).
+    --------------------------------------------------------------------------*/
+
+    bool commit();
+    /*--------------------------------------------------------------------------
+        Write and fsync all pending records.
+
+        Precondition:  None.
+        Postcondition: Every record appended so far is on stable storage.
+                       Returns true on success (or if no journal is open).
+                       Returns false if writing failed: the journal is cut
+                       back to its last durable end, the records stay
+                       pending for the next commit, and failed() is true.
+    --------------------------------------------------------------------------*/
+
+    bool checkpoint();
+    /*--------------------------------------------------------------------------
+        Save the list and truncate the journal.
+
+        Precondition:  Files are open.
+        Postcondition: The checkpoint file is atomically replaced with the
+                       current list, stamped with the next generation, and the
+                       journal is emptied. Returns true on success, false
+                       otherwise (the files on disk still recover either the
+                       previous checkpoint with its journal, or the new one).
+    --------------------------------------------------------------------------*/
+
+    const ListType &list() const;
+    /*--------------------------------------------------------------------------
+        Read-only access to the list.
+
+        Precondition:  None.
+        Postcondition: Returns the in-memory list.
+    --------------------------------------------------------------------------*/
+
+private:
+    bool applyRecord(const char *record, size_t length);
+    /*--------------------------------------------------------------------------
+        Replay one journal record onto the list.
+
+        Precondition:  record holds length bytes.
+        Postcondition: If record starts with a complete record whose checksum
+                       matches, its operation is applied to the list and true
+                       is returned; false otherwise.
+    --------------------------------------------------------------------------*/
+
+    size_t recordSize(unsigned char op) const;
+    /*--------------------------------------------------------------------------
+        Size of a record for the given operation, including the checksum.
+
+        Precondition:  None.
+        Postcondition: Returns the size in bytes, or 0 if op is unknown.
+    --------------------------------------------------------------------------*/
+
+    void append(JournalOp op, bool forced, int position,
+                const ElementType *value, const ElementType *target);
+    /*--------------------------------------------------------------------------
+        Add a record to the journal buffer.
+
+        Precondition:  None.
+        Postcondition: The record is buffered; if syncBatch records are
+                       pending, they are committed (a failure shows in
+                       failed()).
+    --------------------------------------------------------------------------*/
+
+    bool writeJournal(const void *bytes, size_t length, off_t offset);
+    /*--------------------------------------------------------------------------
+        Write a block of bytes to the journal.
+
+        Precondition:  journalFd is open.
+        Postcondition: Writes all 'length' bytes at 'offset', retrying
+                       interrupted and short writes. Returns true on success.
+    --------------------------------------------------------------------------*/
+
+    bool emptyJournal();
+    /*--------------------------------------------------------------------------
+        Truncate the journal to nothing.
+
+        Precondition:  journalFd is open.
+        Postcondition: The journal is empty on stable storage; the next
+                       commit writes a JournalHeader first. Returns true on
+                       success.
+    --------------------------------------------------------------------------*/
+
+    bool syncDirectory() const;
+    /*--------------------------------------------------------------------------
+        Make the last rename of the checkpoint file durable.
+
+        Precondition:  None.
+        Postcondition: The directory holding the checkpoint file is fsynced.
+                       Returns true on success.
+    --------------------------------------------------------------------------*/
+
+    bool replay();
+    /*--------------------------------------------------------------------------
+        Replay the whole journal onto the list.
+
+        Precondition:  journalFd is open.
+        Postcondition: Every valid record of the checkpoint's generation is
+                       applied; the journal is truncated after the last valid
+                       record, or emptied if its header is torn or of an
+                       older generation. Returns false if the journal is of
+                       a newer generation or can not be read.
+    --------------------------------------------------------------------------*/
+
+    bool loadCheckpoint();
+    /*--------------------------------------------------------------------------
+        Read the checkpoint file into the list.
+
+        Precondition:  None.
+        Postcondition: Returns true if the file is missing (list stays empty,
+                       generation 0) or holds a valid list, which is copied
+                       into the list along with its generation; false if the
+                       file is invalid.
+    --------------------------------------------------------------------------*/
+
+    static uint32_t checksum(const char *bytes, size_t length);
+    /*--------------------------------------------------------------------------
+        FNV-1a checksum of a record.
+
+        Precondition:  bytes holds length bytes.
+        Postcondition: Returns the 32-bit checksum.
+    --------------------------------------------------------------------------*/
+
+    ListType current;       // the list
+    string checkpointFile;  // path of the checkpoint file
+    int journalFd;          // journal file descriptor, or -1
+    off_t journalEnd;       // end of the durable records (0: no header yet)
+    uint64_t generation;    // generation of the checkpoint and the journal
+    int syncBatch;          // number of records per group commit
+    int pendingRecords;     // records in buffer not yet committed
+    bool commitFailed;      // last commit failed (see failed())
+    vector<char> buffer;    // encoded records not yet written
+
+}; // end of class declaration
+
+/**************** FUNCTION DEFINITIONS ****************************************/
+
+// Definition of constructor
+template <typename ElementType, int Capacity>
+JournaledList<ElementType, Capacity>::JournaledList()
+    : journalFd(-1), journalEnd(0), generation(0), syncBatch(1),
+      pendingRecords(0), commitFailed(false) {}
+
+// Definition of destructor
+template <typename ElementType, int Capacity>
+JournaledList<ElementType, Capacity>::~JournaledList()
+{
+    close();
+}
+
+// Definition of open()
+template <typename ElementType, int Capacity>
+bool JournaledList<ElementType, Capacity>::open(const char *checkpointPath,
+                                                const char *journalPath,
+                                                int syncBatch)
+{
+    if (journalFd >= 0 || syncBatch < 1)
+        return false;
+
+    checkpointFile = checkpointPath;
+    this->syncBatch = syncBatch;
+    commitFailed = false;
+    current.clear(); // start from an empty list, reset in place
+
+    if (!loadCheckpoint())
+        return false;
+
+    journalFd = ::open(journalPath, O_RDWR | O_CREAT, 0644);
+    if (journalFd < 0)
+        return false;
+
+    if (!replay())
+    {
+        close();
+        return false;
+    }
+    return true;
+}
+
+// Definition of close()
+template <typename ElementType, int Capacity>
+bool JournaledList<ElementType, Capacity>::close()
+{
+    if (journalFd < 0)
+        return true;
+
+    bool ok = commit();
+    ::close(journalFd);
+    journalFd = -1;
+    buffer.clear(); // records that could not be committed are lost
+    pendingRecords = 0;
+    return ok;
+}
+
+// Definition of failed()
+template <typename ElementType, int Capacity>
+bool JournaledList<ElementType, Capacity>::failed() const
+{
+    return commitFailed;
+}
+
+// Definition of insertAtPosition()
+template <typename ElementType, int Capacity>
+bool JournaledList<ElementType, Capacity>::insertAtPosition(const ElementType &value,
+                                                            int position, bool forced)
+{
+    if (!current.insertAtPosition(value, position, forced))
+        return false;
+    append(JOURNAL_INSERT_AT_POSITION, forced, position, &value, nullptr);
+    return true;
+}
+
+// Definition of insertAfterValue()
+template <typename ElementType, int Capacity>
+bool JournaledList<ElementType, Capacity>::insertAfterValue(const ElementType &value,
+                                                            const ElementType &target,
+                                                            bool forced)
+{
+    if (!current.insertAfterValue(value, target, forced))
+        return false;
+    append(JOURNAL_INSERT_AFTER_VALUE, forced, 0, &value, &target);
+    return true;
+}
+
+// Definition of insertBeforeValue()
+template <typename ElementType, int Capacity>
+bool JournaledList<ElementType, Capacity>::insertBeforeValue(const ElementType &value,
+                                                             const ElementType &target,
+                                                             bool forced)
+{
+    if (!current.insertBeforeValue(value, target, forced))
+        return false;
+    append(JOURNAL_INSERT_BEFORE_VALUE, forced, 0, &value, &target);
+    return true;
+}
+
+// Definition of deleteAtPosition()
+template <typename ElementType, int Capacity>
+bool JournaledList<ElementType, Capacity>::deleteAtPosition(int position)
+{
+    if (!current.deleteAtPosition(position))
+        return false;
+    append(JOURNAL_DELETE_AT_POSITION, false, position, nullptr, nullptr);
+    return true;
+}
+
+// Definition of deleteAfterValue()
+template <typename ElementType, int Capacity>
+bool JournaledList<ElementType, Capacity>::deleteAfterValue(const ElementType &target)
+{
+    if (!current.deleteAfterValue(target))
+        return false;
+    append(JOURNAL_DELETE_AFTER_VALUE, false, 0, nullptr, &target);
+    return true;
+}
+
+// Definition of deleteBeforeValue()
+template <typename ElementType, int Capacity>
+bool JournaledList<ElementType, Capacity>::deleteBeforeValue(const ElementType &target)
+{
+    if (!current.deleteBeforeValue(target))
+        return false;
+    append(JOURNAL_DELETE_BEFORE_VALUE, false, 0, nullptr, &target);
+    return true;
+}
+
+// Definition of deleteValue()
+template <typename ElementType, int Capacity>
+bool JournaledList<ElementType, Capacity>::deleteValue(const ElementType &value)
+{
+    if (!current.deleteValue(value))
+        return false;
+    append(JOURNAL_DELETE_VALUE, false, 0, &value, nullptr);
+    return true;
+}
+
+// Definition of sort()
+template <typename ElementType, int Capacity>
+void JournaledList<ElementType, Capacity>::sort()
+{
+    current.sort();
+    append(JOURNAL_SORT, false, 0, nullptr, nullptr);
+}
+
+// Definition of commit()
+template <typename ElementType, int Capacity>
+bool JournaledList<ElementType, Capacity>::commit()
+{
+    if (journalFd < 0 || buffer.empty())
+        return true;
+
+    // A journal without a header gets a fresh one, replacing whatever a
+    // failed checkpoint() left; the checkpoint it follows must be durable
+    // before that old journal is overwritten
+    off_t start = journalEnd;
+    bool ok = true;
+    if (start == 0)
+    {
+        if (!syncDirectory())
+        {
+            commitFailed = true;
+            return false;
+        }
+        JournalHeader header = {};
+        memcpy(header.magic, JOURNAL_MAGIC, sizeof(header.magic));
+        header.generation = generation;
+        ok = ftruncate(journalFd, 0) == 0 &&
+             writeJournal(&header, sizeof(header), 0);
+        start = sizeof(header);
+    }
+
+    // Write the whole batch after the durable records, then make it
+    // durable with a single fsync
+    ok = ok && writeJournal(buffer.data(), buffer.size(), start) &&
+         fsync(journalFd) == 0;
+
+    if (!ok)
+    {
+        // Cut off the torn batch so the next commit rewrites it in place
+        // rather than after bytes replay would stop at
+        if (ftruncate(journalFd, journalEnd) == 0)
+            fsync(journalFd);
+        commitFailed = true;
+        return false;
+    }
+
+    journalEnd = start + buffer.size();
+    buffer.clear();
+    pendingRecords = 0;
+    commitFailed = false;
+    return true;
+}
+
+// Definition of checkpoint()
+template <typename ElementType, int Capacity>
+bool JournaledList<ElementType, Capacity>::checkpoint()
+{
+    if (journalFd < 0 || !commit())
+        return false;
+
+    // Write the new checkpoint beside the old one, then swap it in atomically
+    string temporary = checkpointFile + ".tmp";
+    int fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+        return false;
+
+    alignas(CheckpointHeader) char header[LIST_IMAGE_OFFSET] = {}; // padded header
+    CheckpointHeader *stamp = reinterpret_cast<CheckpointHeader *>(header);
+    initListImageHeader<ElementType, Capacity>(stamp->image);
+    stamp->generation = generation + 1;
+
+    bool ok = ::write(fd, header, sizeof(header)) == (ssize_t)sizeof(header) &&
+              ::write(fd, &current, sizeof(current)) == (ssize_t)sizeof(current) &&
+              fsync(fd) == 0;
+    ::close(fd);
+
+    if (!ok || rename(temporary.c_str(), checkpointFile.c_str()) != 0)
+        return false;
+
+    // The new checkpoint may be the one recovered from now on, so later
+    // records go to a fresh journal of its generation. Until the old
+    // journal is emptied, replay skips it as of the previous generation.
+    generation++;
+    journalEnd = 0;
+
+    // The rename must be durable before the journal is emptied, or a crash
+    // could keep the old checkpoint with an empty journal
+    return syncDirectory() && emptyJournal();
+}
+
+// Definition of writeJournal()
+template <typename ElementType, int Capacity>
+bool JournaledList<ElementType, Capacity>::writeJournal(const void *bytes,
+                                                        size_t length,
+                                                        off_t offset)
+{
+    const char *data = static_cast<const char *>(bytes);
+    size_t written = 0;
+    while (written < length)
+    {
+        ssize_t result = pwrite(journalFd, data + written, length - written,
+                                offset + written);
+        if (result < 0 && errno == EINTR) // interrupted before writing, retry
+            continue;
+        if (result <= 0)
+            return false;
+        written += result;
+    }
+    return true;
+}
+
+// Definition of emptyJournal()
+template <typename ElementType, int Capacity>
+bool JournaledList<ElementType, Capacity>::emptyJournal()
+{
+    journalEnd = 0;
+    return ftruncate(journalFd, 0) == 0 && fsync(journalFd) == 0;
+}
+
+// Definition of syncDirectory()
+template <typename ElementType, int Capacity>
+bool JournaledList<ElementType, Capacity>::syncDirectory() const
+{
+    size_t slash = checkpointFile.rfind('/');
+    string directory = slash == string::npos ? string(".")
+                       : slash == 0          ? string("/")
+                                             : checkpointFile.substr(0, slash);
+
+    int fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+    if (fd < 0)
+        return false;
+    bool ok = fsync(fd) == 0;
+    ::close(fd);
+    return ok;
+}
+
+// Definition of list()
+template <typename ElementType, int Capacity>
+const typename JournaledList<ElementType, Capacity>::ListType &
+JournaledList<ElementType, Capacity>::list() const
+{
+    return current;
+}
+
+// Definition of recordSize()
+template <typename ElementType, int Capacity>
+size_t JournaledList<ElementType, Capacity>::recordSize(unsigned char op) const
+{
+    size_t size = 2 + sizeof(uint32_t); // op, forced and checksum
+    switch (op)
+    {
+    case JOURNAL_INSERT_AT_POSITION:
+        return size + sizeof(int32_t) + sizeof(ElementType);
+    case JOURNAL_INSERT_AFTER_VALUE:
+    case JOURNAL_INSERT_BEFORE_VALUE:
+        return size + 2 * sizeof(ElementType);
+    case JOURNAL_DELETE_AT_POSITION:
+        return size + sizeof(int32_t);
+    case JOURNAL_DELETE_AFTER_VALUE:
+    case JOURNAL_DELETE_BEFORE_VALUE:
+    case JOURNAL_DELETE_VALUE:
+        return size + sizeof(ElementType);
+    case JOURNAL_SORT:
+        return size;
+    default:
+        return 0; // unknown operation
+    }
+}
+
+// Definition of append()
+template <typename ElementType, int Capacity>
+void JournaledList<ElementType, Capacity>::append(JournalOp op, bool forced,
+                                                  int position,
+                                                  const ElementType *value,
+                                                  const ElementType *target)
+{
+    if (journalFd < 0) // not open, nothing to journal
+        return;
+
+    size_t start = buffer.size(); // record begins here in the buffer
+    buffer.push_back((char)op);
+    buffer.push_back(forced ? 1 : 0);
+
+    if (op == JOURNAL_INSERT_AT_POSITION || op == JOURNAL_DELETE_AT_POSITION)
+    {
+        int32_t stored = position;
+        const char *bytes = reinterpret_cast<const char *>(&stored);
+        buffer.insert(buffer.end(), bytes, bytes + sizeof(stored));
+    }
+    if (value != nullptr)
+    {
+        const char *bytes = reinterpret_cast<const char *>(value);
+        buffer.insert(buffer.end(), bytes, bytes + sizeof(ElementType));
+    }
+    if (target != nullptr)
+    {
+        const char *bytes = reinterpret_cast<const char *>(target);
+        buffer.insert(buffer.end(), bytes, bytes + sizeof(ElementType));
+    }
+
+    uint32_t sum = checksum(buffer.data() + start, buffer.size() - start);
+    const char *bytes = reinterpret_cast<const char *>(&sum);
+    buffer.insert(buffer.end(), bytes, bytes + sizeof(sum));
+
+    if (++pendingRecords >= syncBatch) // batch is full, group commit
+        commit();
+}
+
+// Definition of applyRecord()
+template <typename ElementType, int Capacity>
+bool JournaledList<ElementType, Capacity>::applyRecord(const char *record,
+                                                       size_t length)
+{
+    if (length < 2)
+        return false;
+
+    unsigned char op = record[0];
+    size_t size = recordSize(op);
+    if (size == 0 || size > length) // unknown operation or torn record
+        return false;
+
+    uint32_t stored;
+    memcpy(&stored, record + size - sizeof(stored), sizeof(stored));
+    if (stored != checksum(record, size - sizeof(stored)))
+        return false;
+
+    // Decode the fields present for this operation
+    bool forced = record[1] != 0;
+    const char *field = record + 2;
+    int32_t position = 0;
+    ElementType value{}, target{}; // only the fields of the operation are read
+
+    if (op == JOURNAL_INSERT_AT_POSITION || op == JOURNAL_DELETE_AT_POSITION)
+    {
+        memcpy(&position, field, sizeof(position));
+        field += sizeof(position);
+    }
+    if (op == JOURNAL_INSERT_AT_POSITION || op == JOURNAL_INSERT_AFTER_VALUE ||
+        op == JOURNAL_INSERT_BEFORE_VALUE || op == JOURNAL_DELETE_VALUE)
+    {
+        memcpy(&value, field, sizeof(value));
+        field += sizeof(value);
+    }
+    if (op == JOURNAL_INSERT_AFTER_VALUE || op == JOURNAL_INSERT_BEFORE_VALUE ||
+        op == JOURNAL_DELETE_AFTER_VALUE || op == JOURNAL_DELETE_BEFORE_VALUE)
+    {
+        memcpy(&target, field, sizeof(target));
+    }
+
+    switch (op)
+    {
+    case JOURNAL_INSERT_AT_POSITION:
+        current.insertAtPosition(value, position, forced);
+        break;
+    case JOURNAL_INSERT_AFTER_VALUE:
+        current.insertAfterValue(value, target, forced);
+        break;
+    case JOURNAL_INSERT_BEFORE_VALUE:
+        current.insertBeforeValue(value, target, forced);
+        break;
+    case JOURNAL_DELETE_AT_POSITION:
+        current.deleteAtPosition(position);
+        break;
+    case JOURNAL_DELETE_AFTER_VALUE:
+        current.deleteAfterValue(target);
+        break;
+    case JOURNAL_DELETE_BEFORE_VALUE:
+        current.deleteBeforeValue(target);
+        break;
+    case JOURNAL_DELETE_VALUE:
+        current.deleteValue(value);
+        break;
+    case JOURNAL_SORT:
+        current.sort();
+        break;
+    }
+    return true;
+}
+
+// Definition of replay()
+template <typename ElementType, int Capacity>
+bool JournaledList<ElementType, Capacity>::replay()
+{
+    struct stat info;
+    if (fstat(journalFd, &info) != 0)
+        return false;
+
+    // Read the whole journal; it is bounded by the checkpoint interval
+    vector<char> journal(info.st_size);
+    size_t readBytes = 0;
+    while (readBytes < journal.size())
+    {
+        ssize_t result = pread(journalFd, journal.data() + readBytes,
+                               journal.size() - readBytes, readBytes);
+        if (result <= 0)
+            return false;
+        readBytes += result;
+    }
+
+    if (journal.empty())
+    {
+        journalEnd = 0;
+        return true;
+    }
+
+    // The header is written with the first commit, so a torn header has no
+    // committed record behind it; an older generation is already part of
+    // the checkpoint
+    JournalHeader header;
+    if (journal.size() < sizeof(header))
+        return emptyJournal();
+    memcpy(&header, journal.data(), sizeof(header));
+    if (memcmp(header.magic, JOURNAL_MAGIC, sizeof(header.magic)) != 0 ||
+        header.generation < generation)
+        return emptyJournal();
+    if (header.generation > generation) // newer than the checkpoint
+        return false;
+
+    // Apply records until the end or the first torn/corrupt record
+    size_t offset = sizeof(header);
+    while (offset < journal.size() &&
+           applyRecord(journal.data() + offset, journal.size() - offset))
+    {
+        offset += recordSize(journal[offset]);
+    }
+
+    if (offset < journal.size()) // drop the torn tail
+    {
+        if (ftruncate(journalFd, offset) != 0 || fsync(journalFd) != 0)
+            return false;
+    }
+    journalEnd = offset;
+    return true;
+}
+
+// Definition of loadCheckpoint()
+template <typename ElementType, int Capacity>
+bool JournaledList<ElementType, Capacity>::loadCheckpoint()
+{
+    generation = 0;
+    int fd = ::open(checkpointFile.c_str(), O_RDONLY);
+    if (fd < 0) // no checkpoint yet, start from an empty list
+        return true;
+
+    alignas(CheckpointHeader) char header[LIST_IMAGE_OFFSET];
+    const CheckpointHeader *stamp = reinterpret_cast<const CheckpointHeader *>(header);
+    bool ok = ::read(fd, header, sizeof(header)) == (ssize_t)sizeof(header) &&
+              validListImageHeader<ElementType, Capacity>(stamp->image) &&
+              ::read(fd, &current, sizeof(current)) == (ssize_t)sizeof(current);
+    ::close(fd);
+
+    if (ok)
+        generation = stamp->generation;
+    else
+        current.clear();
+    return ok;
+}
+
+// Definition of checksum()
+template <typename ElementType, int Capacity>
+uint32_t JournaledList<ElementType, Capacity>::checksum(const char *bytes,
+                                                       size_t length)
+{
+    uint32_t hash = 2166136261u; // FNV offset basis
+    for (size_t i = 0; i < length; i++)
+    {
+        hash ^= (unsigned char)bytes[i];
+        hash *= 16777619u; // FNV prime
+    }
+    return hash;
+}
+
+#endif
@@ -0,0 +1,228 @@
+/*-- ListEviction.h ------------------------------------------------------------
+    This header file defines the eviction policies of ArrayBasedList: the
+    choice of the element removed when a forced insert finds the NodePool
+    full.
+
+    An ArrayBasedList takes its eviction policy as a template parameter:
+        EvictFirst:  (default) evict the first element (FIFO); no state.
+        EvictTail:   evict the last element; keeps a back link per node.
+        EvictIf<P>:  evict the next element, in list order from where the
+                     last scan stopped, for which the predicate P returns
+                     true; no eviction if none does.
+        EvictClock:  evict the least recently accessed element using a
+                     clock (second chance): one reference bit per node, set
+                     when the element is inserted or found by search(), and
+                     a hand that clears bits until it finds an unset one.
+
+    A policy class holds a member template Policy<ElementType, Capacity>,
+    the object actually stored in the list (the same idea as an allocator's
+    rebind), so its per-node state is sized by the list's Capacity and stays
+    inside the list object. Every policy picks its victim in O(1), or O(1)
+    amortized for EvictClock (every bit cleared was set by one access) and
+    for EvictIf when matching elements are spread through the list.
+
+    Unlinking the victim is O(1) too, except when the victim is the last
+    element: the list then needs its predecessor, which only EvictTail
+    keeps (predecessor()). With EvictIf and EvictClock a last-element victim
+    costs a walk of the list, O(n); EvictFirst only picks the last element
+    when it is the only one.
+
+    Basic operations of a Policy are:
+        victim: Choose the node to evict, or NULL_INDEX for none.
+        predecessor: Node linked before a node, or NULL_INDEX if unknown.
+        linked: Observe a link change ('from' NULL_INDEX means first).
+        accessed: Observe an insert into, or a search hit on, a node.
+        moved: Observe an element moved from one node to another.
+        released: Observe a node returned to the NodePool.
+        reset: Forget every node (the list was cleared).
+------------------------------------------------------------------------------*/
+
+#ifndef LISTEVICTION_H
+#define LISTEVICTION_H
+
+#include <cstring>
+#include "NodePool.h"
+
+using namespace std;
+
+class EvictFirst
+{
+public:
+    template <typename ElementType, int Capacity>
+    class Policy
+    {
+    public:
+        int victim(const NodePool<ElementType, Capacity> &, int first)
+        {
+            return first;
+        }
+        int predecessor(int) const { return NULL_INDEX; }
+        void linked(int, int) {}
+        void accessed(int) {}
+        void moved(int, int) {}
+        void released(int) {}
+        void reset() {}
+        /*----------------------------------------------------------------------
+            The victim is always first; every hook is empty.
+        ----------------------------------------------------------------------*/
+    };
+};
+
+class EvictTail
+{
+public:
+    template <typename ElementType, int Capacity>
+    class Policy
+    {
+    public:
+        /***** Class constructor *****/
+        Policy() { reset(); }
+
+        int victim(const NodePool<ElementType, Capacity> &, int)
+        {
+            return tail;
+        }
+        int predecessor(int node) const { return prev[node]; }
+        void accessed(int) {}
+        void moved(int, int) {}
+        void released(int) {}
+        void reset() { tail = NULL_INDEX; }
+
+        void linked(int from, int to)
+        {
+            if (to != NULL_INDEX)
+                prev[to] = from;
+            else
+                tail = from; // 'from' is now the last node
+        }
+        /*----------------------------------------------------------------------
+            The victim is the last node; prev[] mirrors the 'next' links so
+            the last node can be unlinked without a walk.
+        ----------------------------------------------------------------------*/
+
+    private:
+        static_assert(Capacity != GROWABLE, "EvictTail needs a fixed Capacity");
+
+        int prev[Capacity]; // node linked before each node (NULL_INDEX: first)
+        int tail;           // last node, or NULL_INDEX if the list is empty
+    };
+};
+
+template <typename Predicate>
+class EvictIf
+{
+public:
+    template <typename ElementType, int Capacity>
+    class Policy
+    {
+    public:
+        /***** Class constructor *****/
+        Policy() : cursor(NULL_INDEX) {}
+
+        int victim(const NodePool<ElementType, Capacity> &pool, int first)
+        {
+            int start = cursor != NULL_INDEX ? cursor : first;
+            int node = start;
+            do // at most one lap of the list
+            {
+                int next = pool.getNextOfNode(node);
+                if (predicate(pool.nodeData(node)))
+                {
+                    cursor = next;
+                    return node;
+                }
+                node = next != NULL_INDEX ? next : first;
+            } while (node != start);
+            return NULL_INDEX;
+        }
+        int predecessor(int) const { return NULL_INDEX; }
+        void linked(int, int) {}
+        void accessed(int) {}
+        void reset() { cursor = NULL_INDEX; }
+
+        void moved(int from, int to)
+        {
+            if (cursor == from)
+                cursor = to;
+        }
+
+        void released(int node)
+        {
+            if (cursor == node)
+                cursor = NULL_INDEX;
+        }
+        /*----------------------------------------------------------------------
+            The victim is the first node from the cursor on whose element
+            satisfies the predicate; the cursor follows elements that move
+            and restarts at first when its node is released.
+        ----------------------------------------------------------------------*/
+
+    private:
+        Predicate predicate; // true for elements that may be evicted
+        int cursor;          // node where the next scan starts
+    };
+};
+
+class EvictClock
+{
+public:
+    template <typename ElementType, int Capacity>
+    class Policy
+    {
+    public:
+        /***** Class constructor *****/
+        Policy() { reset(); }
+
+        int victim(const NodePool<ElementType, Capacity> &pool, int first)
+        {
+            if (hand == NULL_INDEX)
+                hand = first;
+
+            // Give every referenced node a second chance
+            while (referenced[hand])
+            {
+                referenced[hand] = false;
+                hand = pool.getNextOfNode(hand);
+                if (hand == NULL_INDEX)
+                    hand = first;
+            }
+            int node = hand;
+            hand = pool.getNextOfNode(node);
+            return node;
+        }
+        int predecessor(int) const { return NULL_INDEX; }
+        void linked(int, int) {}
+        void accessed(int node) { referenced[node] = true; }
+
+        void moved(int from, int to)
+        {
+            referenced[to] = referenced[from];
+            if (hand == from)
+                hand = to;
+        }
+
+        void released(int node)
+        {
+            if (hand == node)
+                hand = NULL_INDEX;
+        }
+
+        void reset()
+        {
+            memset(referenced, 0, sizeof(referenced));
+            hand = NULL_INDEX;
+        }
+        /*----------------------------------------------------------------------
+            The victim is the first node from the hand on whose reference
+            bit is clear; bits found set on the way are cleared.
+        ----------------------------------------------------------------------*/
+
+    private:
+        static_assert(Capacity != GROWABLE, "EvictClock needs a fixed Capacity");
+
+        bool referenced[Capacity]; // reference bit of each node
+        int hand;                  // node the next scan starts at
+    };
+};
+
+#endif
@@ -0,0 +1,267 @@
+/*-- ListInstrumentation.h -----------------------------------------------------
+    This header file defines the instrumentation policies of ArrayBasedList
+    and the ListStats snapshot they produce.
+
+    An ArrayBasedList takes its instrumentation policy as a template
+    parameter:
+        NoInstrumentation:   (default) every hook is an empty inline function,
+                             so instrumentation is compiled out entirely.
+        ListInstrumentation: counts nodes traversed, NodePool acquire/release
+                             calls, inserts that failed because the pool was
+                             full and forced evictions, and keeps a latency
+                             histogram for every list operation.
+
+    Basic operations of a policy are:
+        traversed: Count nodes visited by a walk.
+        acquired / released: Count NodePool acquireNode/releaseNode calls.
+        failedInsert: Count an insert refused because the pool is full.
+        forcedEviction: Count a node evicted by a forced insert.
+        snapshot: Return a copy of the statistics.
+        reset: Set every statistic to zero.
+        Timer: Scoped object recording the latency of one operation.
+
+    Latency histograms have one bucket per power of two of nanoseconds:
+    bucket b counts calls that took less than 2^b ns (and at least
+    2^(b-1) ns).
+------------------------------------------------------------------------------*/
+
+#ifndef LISTINSTRUMENTATION_H
+#define LISTINSTRUMENTATION_H
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+
+using namespace std;
+
+const int LATENCY_BUCKETS = 40; // up to 2^39 ns (about 9 minutes)
+
+/** Instrumented list operations */
+enum ListOperation
+{
+    LIST_OP_INSERT_AT_POSITION,
+    LIST_OP_INSERT_AFTER_VALUE,
+    LIST_OP_INSERT_BEFORE_VALUE,
+    LIST_OP_INSERT_RANGE,
+    LIST_OP_DELETE_AT_POSITION,
+    LIST_OP_DELETE_AFTER_VALUE,
+    LIST_OP_DELETE_BEFORE_VALUE,
+    LIST_OP_DELETE_VALUE,
+    LIST_OP_REMOVE,
+    LIST_OP_SEARCH,
+    LIST_OP_SEARCH_MANY,
+    LIST_OP_SORT,
+    LIST_OP_SIZE,
+    LIST_OP_COUNT
+};
+
+/** Name of each ListOperation, indexed by ListOperation */
+const char *const LIST_OPERATION_NAMES[LIST_OP_COUNT] = {
+    "insertAtPosition", "insertAfterValue", "insertBeforeValue", "insertRange",
+    "deleteAtPosition", "deleteAfterValue", "deleteBeforeValue",
+    "deleteValue", "remove", "search", "searchMany", "sort", "size"};
+
+/** Snapshot of the statistics of an instrumented list */
+struct ListStats
+{
+    uint64_t nodesTraversed;  // nodes visited by all walks
+    uint64_t acquireCalls;    // NodePool::acquireNode calls
+    uint64_t releaseCalls;    // NodePool::releaseNode calls
+    uint64_t failedInserts;   // inserts refused because the pool was full
+    uint64_t forcedEvictions; // nodes evicted by forced inserts
+    uint64_t calls[LIST_OP_COUNT];                      // calls per operation
+    uint64_t latency[LIST_OP_COUNT][LATENCY_BUCKETS];   // latency histograms
+
+    uint64_t latencyPercentile(ListOperation operation, double fraction) const;
+    /*--------------------------------------------------------------------------
+        Estimate a latency percentile of an operation.
+
+        Precondition:  0 <= fraction <= 1.
+        Postcondition: Returns the upper bound in ns of the histogram bucket
+                       holding the given fraction of the calls, or 0 if the
+                       operation was never called.
+    --------------------------------------------------------------------------*/
+};
+
+class NoInstrumentation
+{
+public:
+    /** Timer that records nothing */
+    class Timer
+    {
+    public:
+        Timer(NoInstrumentation &, ListOperation) {}
+    };
+
+    void traversed(uint64_t) {}
+    void acquired() {}
+    void released() {}
+    void failedInsert() {}
+    void forcedEviction() {}
+    ListStats snapshot() const;
+    void reset() {}
+    /*--------------------------------------------------------------------------
+        Empty hooks; snapshot() returns all zeros.
+    --------------------------------------------------------------------------*/
+};
+
+class ListInstrumentation
+{
+public:
+    /** Timer that records the latency of one call when it goes out of scope */
+    class Timer
+    {
+    public:
+        Timer(ListInstrumentation &owner, ListOperation operation);
+        ~Timer();
+
+    private:
+        ListInstrumentation &owner;                 // statistics to update
+        ListOperation operation;                    // operation being timed
+        chrono::steady_clock::time_point start;     // start of the call
+    };
+
+    /***** Class constructor *****/
+    ListInstrumentation();
+    /*--------------------------------------------------------------------------
+        Construct a ListInstrumentation with every statistic at zero.
+    --------------------------------------------------------------------------*/
+
+    void traversed(uint64_t nodes);
+    void acquired();
+    void released();
+    void failedInsert();
+    void forcedEviction();
+    /*--------------------------------------------------------------------------
+        Add to the corresponding counter.
+
+        Precondition:  None.
+        Postcondition: The counter is increased (by 'nodes' for traversed).
+    --------------------------------------------------------------------------*/
+
+    ListStats snapshot() const;
+    /*--------------------------------------------------------------------------
+        Copy the statistics.
+
+        Precondition:  None.
+        Postcondition: Returns the statistics gathered since construction or
+                       the last reset().
+    --------------------------------------------------------------------------*/
+
+    void reset();
+    /*--------------------------------------------------------------------------
+        Set every statistic to zero.
+    --------------------------------------------------------------------------*/
+
+private:
+    void record(ListOperation operation, uint64_t nanoseconds);
+    /*--------------------------------------------------------------------------
+        Add one call of 'operation' to its latency histogram.
+    --------------------------------------------------------------------------*/
+
+    ListStats stats; // statistics gathered so far
+};
+
+/**************** FUNCTION DEFINITIONS ****************************************/
+
+// Definition of ListStats latencyPercentile()
+inline uint64_t ListStats::latencyPercentile(ListOperation operation,
+                                             double fraction) const
+{
+    if (calls[operation] == 0)
+        return 0;
+
+    // Find the bucket holding the requested rank
+    uint64_t rank = (uint64_t)(fraction * (calls[operation] - 1)) + 1;
+    uint64_t seen = 0;
+    for (int bucket = 0; bucket < LATENCY_BUCKETS; bucket++)
+    {
+        seen += latency[operation][bucket];
+        if (seen >= rank)
+            return (uint64_t)1 << bucket;
+    }
+    return (uint64_t)1 << (LATENCY_BUCKETS - 1);
+}
+
+// Definition of NoInstrumentation snapshot()
+inline ListStats NoInstrumentation::snapshot() const
+{
+    ListStats stats;
+    memset(&stats, 0, sizeof(stats));
+    return stats;
+}
+
+// Definition of Timer constructor
+inline ListInstrumentation::Timer::Timer(ListInstrumentation &owner,
+                                         ListOperation operation)
+    : owner(owner), operation(operation), start(chrono::steady_clock::now()) {}
+
+// Definition of Timer destructor
+inline ListInstrumentation::Timer::~Timer()
+{
+    chrono::steady_clock::duration elapsed = chrono::steady_clock::now() - start;
+    owner.record(operation,
+                 chrono::duration_cast<chrono::nanoseconds>(elapsed).count());
+}
+
+// Definition of constructor
+inline ListInstrumentation::ListInstrumentation()
+{
+    reset();
+}
+
+// Definition of traversed()
+inline void ListInstrumentation::traversed(uint64_t nodes)
+{
+    stats.nodesTraversed += nodes;
+}
+
+// Definition of acquired()
+inline void ListInstrumentation::acquired()
+{
+    stats.acquireCalls++;
+}
+
+// Definition of released()
+inline void ListInstrumentation::released()
+{
+    stats.releaseCalls++;
+}
+
+// Definition of failedInsert()
+inline void ListInstrumentation::failedInsert()
+{
+    stats.failedInserts++;
+}
+
+// Definition of forcedEviction()
+inline void ListInstrumentation::forcedEviction()
+{
+    stats.forcedEvictions++;
+}
+
+// Definition of snapshot()
+inline ListStats ListInstrumentation::snapshot() const
+{
+    return stats;
+}
+
+// Definition of reset()
+inline void ListInstrumentation::reset()
+{
+    memset(&stats, 0, sizeof(stats));
+}
+
+// Definition of record()
+inline void ListInstrumentation::record(ListOperation operation,
+                                        uint64_t nanoseconds)
+{
+    int bucket = 0; // smallest power of two above nanoseconds
+    while (bucket < LATENCY_BUCKETS - 1 && ((uint64_t)1 << bucket) <= nanoseconds)
+        bucket++;
+
+    stats.calls[operation]++;
+    stats.latency[operation][bucket]++;
+}
+
+#endif
@@ -0,0 +1,176 @@
+/*-- ListLoader.h --------------------------------------------------------------
+    This header file defines functions that build an ArrayBasedList of numbers
+    directly from a large delimited text stream or file (one value per line,
+    comma separated values, etc.).
+
+    The input is read in fixed-size blocks and parsed with from_chars, and each
+    value is appended in O(1) through ArrayBasedList::Appender. Apart from the
+    list itself, memory use is one LOADER_BLOCK buffer no matter how large the
+    input is.
+
+    Basic operations are:
+        loadDelimited: Append the values of a stream to a list.
+        loadDelimitedFile: Append the values of a file to a list.
+
+    Separators:
+        The delimiter character, spaces, tabs, '\r' and '\n' all separate
+        values; empty fields are skipped.
+------------------------------------------------------------------------------*/
+
+#ifndef LISTLOADER_H
+#define LISTLOADER_H
+
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <istream>
+#include <type_traits>
+#include <vector>
+#include "ArrayBasedList.h"
+
+using namespace std;
+
+const size_t LOADER_BLOCK = 1024 * 1024; // bytes read from the input at once
+
+/** Outcome of a load */
+enum LoadStatus
+{
+    LOAD_OK,          // whole input loaded
+    LOAD_POOL_FULL,   // stopped: the NodePool has no free node left
+    LOAD_PARSE_ERROR, // stopped: a field is not a valid ElementType
+    LOAD_READ_ERROR   // stopped: the input could not be read or opened
+};
+
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+LoadStatus loadDelimited(istream &in,
+                         ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction> &list,
+                         char delimiter = ',', int *loaded = nullptr);
+/*------------------------------------------------------------------------------
+    Append every value of a delimited stream to the end of a list.
+
+    Precondition:  ElementType is an arithmetic type other than bool.
+    Postcondition: Values are appended in input order until the input ends or
+                   an error stops the load; values appended before an error
+                   stay in the list. If 'loaded' is not null, it receives the
+                   number of values appended. Returns the LoadStatus.
+------------------------------------------------------------------------------*/
+
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+LoadStatus loadDelimitedFile(const char *path,
+                             ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction> &list,
+                             char delimiter = ',', int *loaded = nullptr);
+/*------------------------------------------------------------------------------
+    Append every value of a delimited file to the end of a list.
+
+    Precondition:  Same as loadDelimited().
+    Postcondition: Same as loadDelimited(); returns LOAD_READ_ERROR if the
+                   file can not be opened.
+------------------------------------------------------------------------------*/
+
+/**************** FUNCTION DEFINITIONS ****************************************/
+
+// Check if a character separates values
+inline bool isLoaderSeparator(char c, char delimiter)
+{
+    return c == delimiter || c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+// Definition of loadDelimited()
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+LoadStatus loadDelimited(istream &in,
+                         ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction> &list,
+                         char delimiter, int *loaded)
+{
+    static_assert(is_arithmetic<ElementType>::value &&
+                      !is_same<ElementType, bool>::value,
+                  "loadDelimited parses arithmetic ElementTypes only");
+
+    typename ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction>::Appender appender(list);
+    vector<char> block(LOADER_BLOCK);
+    size_t carried = 0; // bytes of an unfinished field kept from last block
+    int count = 0;      // values appended
+    LoadStatus status = LOAD_OK;
+
+    while (status == LOAD_OK)
+    {
+        in.read(block.data() + carried, block.size() - carried);
+        size_t length = carried + in.gcount();
+        bool atEnd = !in; // no more data after this block
+
+        if (in.bad())
+        {
+            status = LOAD_READ_ERROR;
+            break;
+        }
+
+        // Parse every field that is known to be complete
+        const char *cursor = block.data();
+        const char *end = block.data() + length;
+        while (cursor < end)
+        {
+            if (isLoaderSeparator(*cursor, delimiter))
+            {
+                cursor++;
+                continue;
+            }
+
+            const char *fieldEnd = cursor; // find the end of the field
+            while (fieldEnd < end && !isLoaderSeparator(*fieldEnd, delimiter))
+                fieldEnd++;
+            if (fieldEnd == end && !atEnd) // field may continue in next block
+                break;
+
+            ElementType value;
+            from_chars_result result = from_chars(cursor, fieldEnd, value);
+            if (result.ec != errc() || result.ptr != fieldEnd)
+            {
+                status = LOAD_PARSE_ERROR;
+                break;
+            }
+            if (!appender.append(value))
+            {
+                status = LOAD_POOL_FULL;
+                break;
+            }
+            count++;
+            cursor = fieldEnd;
+        }
+
+        if (status != LOAD_OK || atEnd)
+            break;
+
+        // Keep the unfinished field at the front of the block
+        carried = end - cursor;
+        if (carried == block.size()) // a single field fills the whole block
+        {
+            status = LOAD_PARSE_ERROR;
+            break;
+        }
+        memmove(block.data(), cursor, carried);
+    }
+
+    if (loaded != nullptr)
+        *loaded = count;
+    return status;
+}
+
+// Definition of loadDelimitedFile()
+template <typename ElementType, int Capacity, typename Instrumentation,
+          typename Eviction>
+LoadStatus loadDelimitedFile(const char *path,
+                             ArrayBasedList<ElementType, Capacity, Instrumentation, Eviction> &list,
+                             char delimiter, int *loaded)
+{
+    if (loaded != nullptr)
+        *loaded = 0;
+
+    ifstream in(path, ios::binary);
+    if (!in)
+        return LOAD_READ_ERROR;
+    return loadDelimited(in, list, delimiter, loaded);
+}
+
+#endif
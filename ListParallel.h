@@ -0,0 +1,155 @@
+/*-- ListParallel.h ------------------------------------------------------------
+    This header file defines the work-stealing scheduler behind the parallel
+    algorithms of ArrayBasedList (parallelForEach, parallelTransform and
+    parallelReduce).
+
+    The list is split into chunks by one walk of its chain (see
+    ArrayBasedList::chunkMarks), and the chunks are numbered in list order.
+    runChunks() hands them to threads: every thread owns a contiguous range
+    of chunk numbers, takes chunks from the front of its own range, and once
+    it is empty steals chunks from the back of the others'. A range is one
+    atomic word (front in the low half, back in the high half), so taking
+    and stealing are a single compare-and-swap each and need no lock. There
+    are several chunks per thread, so a thread slowed down by costly
+    elements has its remaining chunks taken by the others.
+
+    Basic operations are:
+        defaultThreadCount: Number of hardware threads.
+        chunkCountFor: Number of chunks to split a list into.
+        runChunks: Run a task on every chunk, with work stealing.
+
+    Programs using the parallel algorithms must be linked with -pthread.
+------------------------------------------------------------------------------*/
+
+#ifndef LISTPARALLEL_H
+#define LISTPARALLEL_H
+
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+const int PARALLEL_GRAIN = 1024;  // default number of nodes per mark
+const int CHUNKS_PER_THREAD = 4;  // chunks per thread, the unit of stealing
+
+int defaultThreadCount();
+/*------------------------------------------------------------------------------
+    Get the number of hardware threads, or 1 if it is unknown.
+------------------------------------------------------------------------------*/
+
+int chunkCountFor(int markCount, int threadCount);
+/*------------------------------------------------------------------------------
+    Get the number of chunks to split 'markCount' marks into.
+
+    Precondition:  markCount >= 0 and threadCount >= 1.
+    Postcondition: Returns min(markCount, threadCount * CHUNKS_PER_THREAD),
+                   so that each chunk holds at least one mark.
+------------------------------------------------------------------------------*/
+
+void runChunks(int chunkCount, int threadCount, const function<void(int)> &task);
+/*------------------------------------------------------------------------------
+    Run task(c) for every chunk c in 0..chunkCount - 1 on up to threadCount
+    threads (the calling thread is one of them), with work stealing.
+
+    Precondition:  Tasks on different chunks may run at the same time.
+    Postcondition: Every task has run once and finished. If tasks threw,
+                   the chunks not yet started are skipped and the first
+                   exception is rethrown in the calling thread.
+------------------------------------------------------------------------------*/
+
+/**************** FUNCTION DEFINITIONS ****************************************/
+
+// Definition of defaultThreadCount()
+inline int defaultThreadCount()
+{
+    unsigned threads = thread::hardware_concurrency();
+    return threads > 0 ? (int)threads : 1;
+}
+
+// Definition of chunkCountFor()
+inline int chunkCountFor(int markCount, int threadCount)
+{
+    long long chunks = (long long)threadCount * CHUNKS_PER_THREAD;
+    return markCount < chunks ? markCount : (int)chunks;
+}
+
+// Definition of runChunks()
+inline void runChunks(int chunkCount, int threadCount, const function<void(int)> &task)
+{
+    if (threadCount > chunkCount)
+        threadCount = chunkCount;
+    if (threadCount <= 1) // nothing to share
+    {
+        for (int chunk = 0; chunk < chunkCount; chunk++)
+            task(chunk);
+        return;
+    }
+
+    /** Range of chunks [front, back) of a thread, in one atomic word */
+    struct alignas(64) Range
+    {
+        atomic<uint64_t> bounds; // front in the low half, back in the high half
+    };
+    unique_ptr<Range[]> ranges(new Range[threadCount]);
+    for (int t = 0; t < threadCount; t++)
+    {
+        uint64_t front = (uint64_t)chunkCount * t / threadCount;
+        uint64_t back = (uint64_t)chunkCount * (t + 1) / threadCount;
+        ranges[t].bounds.store(front | back << 32, memory_order_relaxed);
+    }
+
+    atomic<bool> failed(false);  // a task threw: start no more chunks
+    exception_ptr firstError;    // the exception rethrown
+    mutex errorLock;             // guards firstError
+
+    auto worker = [&](int self) {
+        for (int step = 0; step < threadCount && !failed.load(memory_order_relaxed);)
+        {
+            // Own range first (take from the front), then the others' (steal
+            // from the back)
+            int owner = (self + step) % threadCount;
+            atomic<uint64_t> &bounds = ranges[owner].bounds;
+            uint64_t seen = bounds.load(memory_order_relaxed);
+            uint32_t front = (uint32_t)seen, back = (uint32_t)(seen >> 32);
+            if (front == back) // range exhausted, try the next one
+            {
+                step++;
+                continue;
+            }
+            uint32_t chunk = owner == self ? front : back - 1;
+            uint64_t taken = owner == self ? seen + 1 : seen - ((uint64_t)1 << 32);
+            if (!bounds.compare_exchange_weak(seen, taken, memory_order_relaxed))
+                continue; // raced with another thread, look again
+
+            try
+            {
+                task((int)chunk);
+            }
+            catch (...)
+            {
+                lock_guard<mutex> guard(errorLock);
+                if (!firstError)
+                    firstError = current_exception();
+                failed.store(true, memory_order_relaxed);
+            }
+        }
+    };
+
+    vector<thread> workers;
+    for (int t = 1; t < threadCount; t++)
+        workers.emplace_back(worker, t);
+    worker(0);
+    for (size_t i = 0; i < workers.size(); i++)
+        workers[i].join();
+
+    if (firstError)
+        rethrow_exception(firstError);
+}
+
+#endif
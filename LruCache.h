@@ -0,0 +1,379 @@
+/*-- LruCache.h ----------------------------------------------------------------
+    This header file defines the template class LruCache, a bounded key-value
+    cache that evicts the least recently used entry, built on a NodePool.
+
+    Entries live in the NodePool. Each entry is linked twice:
+        - in the recency chain, most recently used first, through the
+          node's 'next' field and the entry's 'prev' field;
+        - in the chain of its hash bucket, through the entry's 'chain' field.
+    Buckets are an array of node indices, so get and put are O(1) on
+    average and nothing is allocated after construction (except by the key
+    and value types themselves). Capacity, the size of the pool, is the
+    bound of the cache.
+
+    Basic operations are:
+        Constructor: Constructs an empty cache.
+        get: Look up a key, marking its entry as most recently used.
+        contains: Check if a key is cached, without changing recency.
+        put: Add or update an entry, evicting the least recently used one
+             if the cache is full.
+        erase: Remove the entry of a key.
+        size: Returns the number of entries.
+        isEmpty: Check if the cache is empty.
+        clear: Remove every entry.
+        display: Print entries, most recently used first.
+
+    KeyType must be equality comparable and have a std::hash specialization.
+
+    Class Invariant:
+        1. mostRecent / leastRecent store the ends of the recency chain, or
+           NULL_INDEX if the cache is empty.
+        2. Every entry in use is in exactly one bucket chain, the one of
+           hash(key) & (BUCKET_COUNT - 1), and keys are unique.
+------------------------------------------------------------------------------*/
+
+#ifndef LRUCACHE_H
+#define LRUCACHE_H
+
+#include <functional>
+#include <iostream>
+#include "NodePool.h"
+
+using namespace std;
+
+// Smallest power of two at least twice 'capacity' (load factor <= 0.5)
+constexpr int lruBucketCount(int capacity)
+{
+    int count = 1;
+    while (count < 2 * capacity)
+        count *= 2;
+    return count;
+}
+
+template <typename KeyType, typename ValueType, int Capacity = CAPACITY>
+class LruCache
+{
+    static_assert(Capacity != GROWABLE, "LruCache is bounded by a fixed Capacity");
+
+public:
+    /******** Member Functions ********/
+
+    /***** Class constructor *****/
+    LruCache();
+    /*--------------------------------------------------------------------------
+        Construct an empty LruCache.
+
+        Precondition:  None.
+        Postcondition: An empty cache is constructed; every bucket is empty.
+    --------------------------------------------------------------------------*/
+
+    bool get(const KeyType &key, ValueType &value);
+    /*--------------------------------------------------------------------------
+        Look up the value of a key.
+
+        Precondition:  None.
+        Postcondition: If the key is cached, its value is copied to 'value',
+                       its entry becomes the most recently used and true is
+                       returned. Otherwise, returns false.
+    --------------------------------------------------------------------------*/
+
+    bool contains(const KeyType &key) const;
+    /*--------------------------------------------------------------------------
+        Check if a key is cached.
+
+        Precondition:  None.
+        Postcondition: Returns true if the key is cached; recency is not
+                       changed.
+    --------------------------------------------------------------------------*/
+
+    bool put(const KeyType &key, const ValueType &value);
+    /*--------------------------------------------------------------------------
+        Add or update the entry of a key.
+
+        Precondition:  None.
+        Postcondition: The key maps to 'value' and its entry is the most
+                       recently used. If the key was new and the cache was
+                       full, the least recently used entry is evicted and its
+                       node reused; returns true in that case, false
+                       otherwise.
+    --------------------------------------------------------------------------*/
+
+    bool erase(const KeyType &key);
+    /*--------------------------------------------------------------------------
+        Remove the entry of a key.
+
+        Precondition:  None.
+        Postcondition: Returns true if the key was cached and its node is back
+                       in the NodePool, false if the key was not cached.
+    --------------------------------------------------------------------------*/
+
+    int size() const;
+    /*--------------------------------------------------------------------------
+        Returns the number of entries, in O(1).
+
+        Precondition:  None.
+        Postcondition: Number of cached keys is returned.
+    --------------------------------------------------------------------------*/
+
+    bool isEmpty() const;
+    /*--------------------------------------------------------------------------
+        Check if the cache is empty.
+
+        Precondition:  None.
+        Postcondition: Returns true if no key is cached, false otherwise.
+    --------------------------------------------------------------------------*/
+
+    void clear();
+    /*--------------------------------------------------------------------------
+        Remove every entry.
+
+        Precondition:  None.
+        Postcondition: The cache is empty and every node is free.
+    --------------------------------------------------------------------------*/
+
+    void display(ostream &out) const;
+    /*--------------------------------------------------------------------------
+        Display every entry, most recently used first.
+
+        Precondition:  KeyType and ValueType support operator<<.
+        Postcondition: Outputs "key: value" pairs separated by ", " to 'out',
+                       or "Cache is empty", followed by '\n'.
+    --------------------------------------------------------------------------*/
+
+private:
+    /** Private class Entry: data of a pool node */
+    class Entry
+    {
+    public:
+        KeyType key;     // key of the entry
+        ValueType value; // value of the entry
+        int prev;        // more recently used entry, or NULL_INDEX
+        int chain;       // next entry in the same bucket, or NULL_INDEX
+    };
+
+    static const int BUCKET_COUNT = lruBucketCount(Capacity);
+
+    int bucketOf(const KeyType &key) const;
+    /*--------------------------------------------------------------------------
+        Bucket of a key.
+    --------------------------------------------------------------------------*/
+
+    int find(const KeyType &key) const;
+    /*--------------------------------------------------------------------------
+        Node of a key, or NULL_INDEX if it is not cached.
+    --------------------------------------------------------------------------*/
+
+    void unlink(int node);
+    void pushFront(int node);
+    /*--------------------------------------------------------------------------
+        Remove a node from the recency chain / link it as the most recently
+        used.
+    --------------------------------------------------------------------------*/
+
+    void unhash(int node);
+    /*--------------------------------------------------------------------------
+        Remove a node from its bucket chain.
+    --------------------------------------------------------------------------*/
+
+    NodePool<Entry, Capacity> pool; // entries and recency 'next' links
+    int buckets[BUCKET_COUNT];      // first node of each bucket chain
+    int mostRecent;                 // most recently used entry
+    int leastRecent;                // least recently used entry
+    int count;                      // number of entries
+
+}; // end of class declaration
+
+/**************** FUNCTION DEFINITIONS ****************************************/
+
+// Definition of constructor
+template <typename KeyType, typename ValueType, int Capacity>
+LruCache<KeyType, ValueType, Capacity>::LruCache()
+{
+    clear();
+}
+
+// Definition of get()
+template <typename KeyType, typename ValueType, int Capacity>
+bool LruCache<KeyType, ValueType, Capacity>::get(const KeyType &key, ValueType &value)
+{
+    int node = find(key);
+    if (node == NULL_INDEX) // not cached
+        return false;
+
+    if (node != mostRecent) // move entry to the front of the recency chain
+    {
+        unlink(node);
+        pushFront(node);
+    }
+    value = pool.nodeData(node).value;
+    return true;
+}
+
+// Definition of contains()
+template <typename KeyType, typename ValueType, int Capacity>
+bool LruCache<KeyType, ValueType, Capacity>::contains(const KeyType &key) const
+{
+    return find(key) != NULL_INDEX;
+}
+
+// Definition of put()
+template <typename KeyType, typename ValueType, int Capacity>
+bool LruCache<KeyType, ValueType, Capacity>::put(const KeyType &key, const ValueType &value)
+{
+    int node = find(key);
+    if (node != NULL_INDEX) // update an existing entry
+    {
+        pool.nodeData(node).value = value;
+        if (node != mostRecent)
+        {
+            unlink(node);
+            pushFront(node);
+        }
+        return false;
+    }
+
+    bool evicted = false;
+    node = pool.acquireNode();
+    if (node == NULL_INDEX) // cache is full, reuse the least recently used node
+    {
+        node = leastRecent;
+        unlink(node);
+        unhash(node);
+        count--;
+        evicted = true;
+    }
+
+    // Fill the entry and link it in its bucket and at the front
+    Entry &entry = pool.nodeData(node);
+    entry.key = key;
+    entry.value = value;
+    int bucket = bucketOf(key);
+    entry.chain = buckets[bucket];
+    buckets[bucket] = node;
+    pushFront(node);
+    count++;
+    return evicted;
+}
+
+// Definition of erase()
+template <typename KeyType, typename ValueType, int Capacity>
+bool LruCache<KeyType, ValueType, Capacity>::erase(const KeyType &key)
+{
+    int node = find(key);
+    if (node == NULL_INDEX) // not cached
+        return false;
+
+    unlink(node);
+    unhash(node);
+    pool.releaseNode(node);
+    count--;
+    return true;
+}
+
+// Definition of size()
+template <typename KeyType, typename ValueType, int Capacity>
+int LruCache<KeyType, ValueType, Capacity>::size() const
+{
+    return count;
+}
+
+// Definition of isEmpty()
+template <typename KeyType, typename ValueType, int Capacity>
+bool LruCache<KeyType, ValueType, Capacity>::isEmpty() const
+{
+    return count == 0;
+}
+
+// Definition of clear()
+template <typename KeyType, typename ValueType, int Capacity>
+void LruCache<KeyType, ValueType, Capacity>::clear()
+{
+    pool.reset();
+    for (int bucket = 0; bucket < BUCKET_COUNT; bucket++)
+        buckets[bucket] = NULL_INDEX;
+    mostRecent = NULL_INDEX;
+    leastRecent = NULL_INDEX;
+    count = 0;
+}
+
+// Definition of display()
+template <typename KeyType, typename ValueType, int Capacity>
+void LruCache<KeyType, ValueType, Capacity>::display(ostream &out) const
+{
+    if (mostRecent == NULL_INDEX) // cache is empty
+    {
+        out << "Cache is empty";
+    }
+    else
+    {
+        // Loop through the recency chain
+        for (int i = mostRecent; i != NULL_INDEX; i = pool.getNextOfNode(i))
+        {
+            out << pool.nodeData(i).key << ": " << pool.nodeData(i).value;
+            if (pool.getNextOfNode(i) != NULL_INDEX) // check if not last entry
+                out << ", ";
+        }
+    }
+    out << '\n';
+}
+
+// Definition of bucketOf()
+template <typename KeyType, typename ValueType, int Capacity>
+int LruCache<KeyType, ValueType, Capacity>::bucketOf(const KeyType &key) const
+{
+    return hash<KeyType>()(key) & (BUCKET_COUNT - 1);
+}
+
+// Definition of find()
+template <typename KeyType, typename ValueType, int Capacity>
+int LruCache<KeyType, ValueType, Capacity>::find(const KeyType &key) const
+{
+    int node = buckets[bucketOf(key)];
+    while (node != NULL_INDEX && !(pool.nodeData(node).key == key))
+        node = pool.nodeData(node).chain;
+    return node;
+}
+
+// Definition of unlink()
+template <typename KeyType, typename ValueType, int Capacity>
+void LruCache<KeyType, ValueType, Capacity>::unlink(int node)
+{
+    int prev = pool.nodeData(node).prev;
+    int next = pool.getNextOfNode(node);
+
+    if (prev == NULL_INDEX) // node was the most recent
+        mostRecent = next;
+    else
+        pool.setNextOfNode(prev, next);
+
+    if (next == NULL_INDEX) // node was the least recent
+        leastRecent = prev;
+    else
+        pool.nodeData(next).prev = prev;
+}
+
+// Definition of pushFront()
+template <typename KeyType, typename ValueType, int Capacity>
+void LruCache<KeyType, ValueType, Capacity>::pushFront(int node)
+{
+    pool.nodeData(node).prev = NULL_INDEX;
+    pool.setNextOfNode(node, mostRecent);
+
+    if (mostRecent == NULL_INDEX) // cache was empty
+        leastRecent = node;
+    else
+        pool.nodeData(mostRecent).prev = node;
+    mostRecent = node;
+}
+
+// Definition of unhash()
+template <typename KeyType, typename ValueType, int Capacity>
+void LruCache<KeyType, ValueType, Capacity>::unhash(int node)
+{
+    int *link = &buckets[bucketOf(pool.nodeData(node).key)];
+    while (*link != node)
+        link = &pool.nodeData(*link).chain;
+    *link = pool.nodeData(node).chain;
+}
+
+#endif
@@ -6,7 +6,9 @@
     Basic operations are:
         Constructor: Constructs NodePool as a free list
         acquireNode: Acquire first free node
+        acquireChain: Acquire several free nodes, already linked together
         releaseNode: Release previously used node
+        releaseChain: Release a chain of used nodes in O(1)
         setNode: Assigns both the data and next fields of a specific node.
         displayFree: Outputs the indices of all currently free nodes in the pool.
         displayInUse: Outputs the data of all nodes currently in use, starting
@@ -14,12 +16,43 @@
         getNextOfNode: Retrieves the next index stored in a specific node.
         setNextOfNode: Updates the next index of a specific node.
         getNodeData: Returns the data stored in a specific node.
+        nodeData: Returns a reference to the data stored in a specific node.
         setNodeData: Sets the data stored in a specific node.
+        indexOf: Returns the index of the node holding some data.
         switchOrderOfNodes: Switch the content of two nodes.
+        reset: Return every node to the free list.
+        usedCount: Returns the number of nodes currently in use.
+        highWaterMark: Returns the largest number of nodes ever in use.
+        occupancy: Returns a PoolStats report of occupancy, fragmentation
+                   of the free list and locality of a client's chain.
+        capacity: Returns the number of nodes in the pool.
+        maxSize: Returns the largest number of nodes the pool can hold.
+        shrink: (growable pool only) Free the chunks at the end of the pool
+                that hold no used node.
 
+    Capacity is a template parameter (default CAPACITY) giving the number of
+    nodes in the pool.
+
+    With Capacity == GROWABLE the pool starts empty and grows instead: its
+    nodes live in chunks of CHUNK_NODES nodes, found through a directory of
+    chunk pointers (node i is node i % CHUNK_NODES of chunk i / CHUNK_NODES).
+    When the free list is empty, acquireNode allocates one more chunk and
+    threads its nodes onto the free list. A chunk never moves, so indices
+    (and references to node data) stay valid until shrink() frees the chunk
+    or the pool is destroyed. acquireNode returns NULL_INDEX only if the
+    allocation fails. A growable pool owns heap memory: copying it copies
+    every chunk.
+
+    A growable pool takes its memory (chunks and chunk directory) from a
+    std::pmr::memory_resource given to its constructor,
+    pmr::get_default_resource() by default, so pools can be placed in
+    monotonic buffers, arenas or huge pages. As for pmr containers, a copy
+    uses the default resource and assignment keeps the resource of the
+    target. shrink() takes its temporary table from the heap instead, so it
+    never grows an arena.
 
     Class Invariant:
-        1. The node pool elements are stored in positions 0, 1,..., CAPACITY - 1
+        1. The node pool elements are stored in positions 0, 1,..., Capacity - 1
         2. freeHead stores the index of the first free node, or NULL_INDEX if
             all nodes are in use.
         3. Every free node is linked to the next free node through its 'next'
@@ -29,13 +62,66 @@
 #ifndef NODEPOOL_H
 #define NODEPOOL_H
 
+#include <algorithm>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
 #include <iostream>
+#include <memory_resource>
+#include <new>
+#include <vector>
 using namespace std;
 
 const int CAPACITY = 10;
 const int NULL_INDEX = -1;
+const int GROWABLE = 0;                      // Capacity of a growable pool
+const int CHUNK_SHIFT = 10;                  // log2 of CHUNK_NODES
+const int CHUNK_NODES = 1 << CHUNK_SHIFT;    // nodes per chunk of a growable pool
+const int MAX_GROWABLE_NODES = INT_MAX / CHUNK_NODES * CHUNK_NODES;
+const int FREE_RUN_BUCKETS = 32; // one per power of two of an int run length
 
-template <typename ElementType>
+/** Occupancy and fragmentation report of a NodePool */
+struct PoolStats
+{
+    int capacity;               // nodes in the pool
+    int used;                   // nodes in use
+    int free;                   // nodes in the free list
+    int highWater;              // largest number of nodes ever in use
+    size_t elementBytes;        // sizeof(ElementType)
+    size_t nodeBytes;           // bytes per node (element, link, padding)
+    size_t poolBytes;           // bytes of the whole pool
+    double bytesPerLiveElement; // poolBytes / used (0 if nothing is used)
+
+    int freeRunCount;                // runs in the free list
+    int longestFreeRun;              // nodes in the longest run
+    int freeRuns[FREE_RUN_BUCKETS];  // runs of 2^b to 2^(b+1) - 1 nodes
+
+    int chainLength;         // nodes in the chain walked
+    int sequentialLinks;     // links from node i to node i + 1
+    int backwardLinks;       // links to a lower index
+    double meanLinkDistance; // average |next - index| over the links
+
+    void writeJson(ostream &out) const;
+    /*--------------------------------------------------------------------------
+        Write the report as one JSON object.
+
+        Precondition:  None.
+        Postcondition: Outputs every field to 'out' as a JSON object (freeRuns
+                       as an array indexed by bucket), followed by '\n'.
+    --------------------------------------------------------------------------*/
+};
+
+template <typename Pool>
+void measureLinks(const Pool &pool, int freeHead, int firstUsed, PoolStats &stats);
+/*------------------------------------------------------------------------------
+    Fill the free run and chain fields of a PoolStats (see occupancy()).
+
+    Precondition:  freeHead and firstUsed head valid chains of 'pool'.
+    Postcondition: Adds the runs of the free list and the link counts and
+                   distances of the chain to 'stats', in one walk of each.
+------------------------------------------------------------------------------*/
+
+template <typename ElementType, int Capacity = CAPACITY>
 class NodePool
 {
 private:
@@ -60,7 +146,7 @@ private:
         /*----------------------------------------------------------------------
             Construct a Node object.
 
-            Precondition:  0 <= next < CAPACITY or next == -1
+            Precondition:  0 <= next < Capacity or next == -1
             Postcondition: A node object is constructed; next is initialized
                            to next parameter; data contains a garbage value.
         ----------------------------------------------------------------------*/
@@ -69,7 +155,7 @@ private:
         /*----------------------------------------------------------------------
             Construct a Node object.
 
-            Precondition:  0 <= next < CAPACITY or next == -1
+            Precondition:  0 <= next < Capacity or next == -1
             Postcondition: A node object is constructed; next is initialized to
                            next parameter; data is initialized to data parameter.
         ----------------------------------------------------------------------*/
@@ -103,21 +189,43 @@ public:
                        Otherwise, returns NULL_INDEX.
     --------------------------------------------------------------------------*/
 
+    int acquireChain(int count, int &last);
+    /*--------------------------------------------------------------------------
+        Acquire the first 'count' free nodes at once.
+
+        Precondition:  1 <= count <= Capacity - usedCount().
+        Postcondition: The first 'count' nodes of the free list are removed
+                       from it in one cut, still linked in free-list order
+                       (physically contiguous after a reset()). Returns the
+                       index of the first one; 'last' receives the index of
+                       the last one, whose next is NULL_INDEX.
+    --------------------------------------------------------------------------*/
+
     bool releaseNode(int index);
     /*--------------------------------------------------------------------------
         Release previously used node.
 
-        Precondition:  0 <= index < CAPACITY
+        Precondition:  0 <= index < Capacity
         Postcondition: Release node at index, inserting it at the front of
                        the free list. Returns true if index is valid,
                        false otherwise.
     --------------------------------------------------------------------------*/
 
+    void releaseChain(int head, int tail, int count);
+    /*--------------------------------------------------------------------------
+        Release a chain of previously used nodes at once.
+
+        Precondition:  head..tail are 'count' used nodes linked through their
+                       next fields (tail's next may be anything).
+        Postcondition: The whole chain is inserted at the front of the free
+                       list by relinking tail, in O(1).
+    --------------------------------------------------------------------------*/
+
     void setNode(int index, const ElementType &data, int next);
     /*--------------------------------------------------------------------------
         Set the data and next fields of the node at the specified index.
 
-        Precondition:  0 <= index < CAPACITY.
+        Precondition:  0 <= index < Capacity.
         Postcondition: The node at position 'index' has its data field set to
                        'data' and its next field set to 'next'.
 ------------------------------------------------------------------------------*/
@@ -136,7 +244,7 @@ public:
     /*--------------------------------------------------------------------------
         Display all nodes currently in use, starting from a given index.
 
-        Precondition:  0 <= firstUsed < CAPACITY or firstUsed == -1
+        Precondition:  0 <= firstUsed < Capacity or firstUsed == -1
                        The client must ensure that nodes starting from
                        'firstUsed' form a valid linked structure using the
                        'next' fields.
@@ -149,7 +257,7 @@ public:
     /*---------------------------------------------------------------------------
         Retrieve the next index stored in the node at the specified position.
 
-        Precondition:  0 <= index < CAPACITY.
+        Precondition:  0 <= index < Capacity.
         Postcondition: Returns the value of nodePool[index].next.
 ---------------------------------------------------------------------------*/
 
@@ -157,7 +265,7 @@ public:
     /*---------------------------------------------------------------------------
         Update the next field of the node at the specified index.
 
-        Precondition:  0 <= index < CAPACITY.
+        Precondition:  0 <= index < Capacity.
         Postcondition: The node at 'index' has its next field updated to the
                        specified 'next' value (which may be another valid index
                        or NULL_INDEX).
@@ -167,66 +275,161 @@ public:
     /*---------------------------------------------------------------------------
         Retrieve the data stored in the node at the specified index.
 
-        Precondition:  0 <= index < CAPACITY.
+        Precondition:  0 <= index < Capacity.
         Postcondition: Returns the ElementType data stored in nodePool[index].
 ---------------------------------------------------------------------------*/
 
+    const ElementType &nodeData(int index) const;
+    ElementType &nodeData(int index);
+    /*---------------------------------------------------------------------------
+        Access the data stored in the node at the specified index without
+        copying it.
+
+        Precondition:  0 <= index < Capacity.
+        Postcondition: Returns a reference to nodePool[index].data.
+---------------------------------------------------------------------------*/
+
     void setNodeData(int index, const ElementType &data);
     /*--------------------------------------------------------------------------
         Change the data of the node at the specified index.
 
-        Precondition:  0 <= index < CAPACITY.
+        Precondition:  0 <= index < Capacity.
         Postcondition: The node at position 'index' has its data field set to
                        'data'.
 ------------------------------------------------------------------------------*/
 
+    int indexOf(const ElementType *data) const;
+    /*--------------------------------------------------------------------------
+        Find the node holding the data at an address.
+
+        Precondition:  None.
+        Postcondition: Returns i if 'data' is &nodeData(i), or NULL_INDEX if
+                       'data' is not the data of a node of this pool, in O(1).
+------------------------------------------------------------------------------*/
+
     void switchOrderOfNodes(int node1, int node2);
     /*--------------------------------------------------------------------------
         Switch the data of nodes at indexes node1 and node2
 
-        Precondition:  0 <= node1 < CAPACITY and 0 <= node2 < CAPACITY
+        Precondition:  0 <= node1 < Capacity and 0 <= node2 < Capacity
         Postcondition: The nodes at positions node1 and node2 have their data
                        switched.
 ------------------------------------------------------------------------------*/
 
+    void reset();
+    /*--------------------------------------------------------------------------
+        Return every node to the free list.
+
+        Precondition:  None.
+        Postcondition: The pool is in the same state as a newly constructed
+                       one: the free list links 0, 1,..., Capacity - 1 in
+                       order, so the next nodes acquired are physically
+                       contiguous. Any list using the pool must be emptied by
+                       its client.
+------------------------------------------------------------------------------*/
+
+    int usedCount() const;
+    /*--------------------------------------------------------------------------
+        Get the number of nodes in use.
+
+        Precondition:  None.
+        Postcondition: Returns the number of acquired nodes not yet released,
+                       in O(1).
+------------------------------------------------------------------------------*/
+
+    int highWaterMark() const;
+    /*--------------------------------------------------------------------------
+        Get the largest number of nodes ever in use at once.
+
+        Precondition:  None.
+        Postcondition: Returns the maximum of usedCount() since construction
+                       or the last reset(), in O(1).
+------------------------------------------------------------------------------*/
+
+    PoolStats occupancy(int firstUsed) const;
+    /*--------------------------------------------------------------------------
+        Report the occupancy and fragmentation of the pool.
+
+        Precondition:  0 <= firstUsed < Capacity or firstUsed == -1, the head
+                       of a valid chain of used nodes (as for displayInUse).
+        Postcondition: Returns the counts, sizes and high-water mark of the
+                       pool. A free run is a stretch of the free list whose
+                       indices are consecutive (i, i + 1,...), so the
+                       nodes it hands out next are contiguous in memory; the
+                       chain fields describe how closely the order of the
+                       chain starting at 'firstUsed' follows the array order.
+                       Computed in one walk of each list, without allocating.
+------------------------------------------------------------------------------*/
+
+    int capacity() const;
+    /*--------------------------------------------------------------------------
+        Get the number of nodes in the pool.
+
+        Precondition:  None.
+        Postcondition: Returns Capacity.
+------------------------------------------------------------------------------*/
+
+    int maxSize() const;
+    /*--------------------------------------------------------------------------
+        Get the largest number of nodes the pool can ever hold.
+
+        Precondition:  None.
+        Postcondition: Returns Capacity (a growable pool returns
+                       MAX_GROWABLE_NODES), so usedCount() == maxSize()
+                       means the pool is full.
+------------------------------------------------------------------------------*/
+
 private:
-    Node nodePool[CAPACITY]; // Pool nodes containing data
+    static_assert(Capacity > 0, "NodePool Capacity must be positive");
+
+    Node nodePool[Capacity]; // Pool nodes containing data
     int freeHead;            // Index of first free node in the linked free list
+    int used;                // Number of nodes in use
+    int highWater;           // Largest number of nodes ever in use
 
 }; // end of class declaration
 
 /**************** FUNCTION DEFINITIONS ****************************************/
 
 // Definition of Node no-arg constructor
-template <typename ElementType>
-NodePool<ElementType>::Node::Node()
+template <typename ElementType, int Capacity>
+NodePool<ElementType, Capacity>::Node::Node()
     : next(NULL_INDEX) {} // data is garbage
 
 // Definition of Node constructor with one parameter next
-template <typename ElementType>
-NodePool<ElementType>::Node::Node(int next)
+template <typename ElementType, int Capacity>
+NodePool<ElementType, Capacity>::Node::Node(int next)
     : next(next) {} // data is garbage
 
 // Definition of Node constructor with two parameters data and next
-template <typename ElementType>
-NodePool<ElementType>::Node::Node(ElementType data, int next)
+template <typename ElementType, int Capacity>
+NodePool<ElementType, Capacity>::Node::Node(ElementType data, int next)
     : data(data), next(next) {}
 
 // Definition of NodePool constructor
-template <typename ElementType>
-NodePool<ElementType>::NodePool() : freeHead(0)
+template <typename ElementType, int Capacity>
+NodePool<ElementType, Capacity>::NodePool() : freeHead(0)
+{
+    reset();
+}
+
+// Definition of reset()
+template <typename ElementType, int Capacity>
+void NodePool<ElementType, Capacity>::reset()
 {
     // Link all nodes into a free list
-    for (int i = 0; i < CAPACITY - 1; i++)
+    for (int i = 0; i < Capacity - 1; i++)
         nodePool[i].next = i + 1;
 
-    nodePool[CAPACITY - 1].next = NULL_INDEX; // last node points to NULL
+    nodePool[Capacity - 1].next = NULL_INDEX; // last node points to NULL
     freeHead = 0;                             // free list starts at node 0
+    used = 0;
+    highWater = 0;
 }
 
 // Definition of acquireNode()
-template <typename ElementType>
-int NodePool<ElementType>::acquireNode()
+template <typename ElementType, int Capacity>
+int NodePool<ElementType, Capacity>::acquireNode()
 {
     if (freeHead == NULL_INDEX)
         return NULL_INDEX; // no free nodes
@@ -234,33 +437,65 @@ int NodePool<ElementType>::acquireNode()
     int index = freeHead;              // take first free node
     freeHead = nodePool[index].next;   // move head to next free node
     nodePool[index].next = NULL_INDEX; // disconnect from free list
+
+    if (++used > highWater)
+        highWater = used;
     return index;
 }
 
+// Definition of acquireChain()
+template <typename ElementType, int Capacity>
+int NodePool<ElementType, Capacity>::acquireChain(int count, int &last)
+{
+    int head = freeHead; // chain starts at the first free node
+    last = head;
+    for (int i = 1; i < count; i++)
+        last = nodePool[last].next;
+
+    freeHead = nodePool[last].next;   // free list resumes after the chain
+    nodePool[last].next = NULL_INDEX; // disconnect chain from free list
+
+    used += count;
+    if (used > highWater)
+        highWater = used;
+    return head;
+}
+
 // Definition of releaseNode()
-template <typename ElementType>
-bool NodePool<ElementType>::releaseNode(int index)
+template <typename ElementType, int Capacity>
+bool NodePool<ElementType, Capacity>::releaseNode(int index)
 {
-    if (index < 0 || index >= CAPACITY)
+    if (index < 0 || index >= Capacity)
         return false; // invalid index
 
     // Insert node at the front of the free list
     nodePool[index].next = freeHead;
     freeHead = index;
+    used--;
     return true;
 }
 
+// Definition of releaseChain()
+template <typename ElementType, int Capacity>
+void NodePool<ElementType, Capacity>::releaseChain(int head, int tail, int count)
+{
+    // Insert the chain at the front of the free list
+    nodePool[tail].next = freeHead;
+    freeHead = head;
+    used -= count;
+}
+
 // Definition of setNode()
-template <typename ElementType>
-void NodePool<ElementType>::setNode(int index, const ElementType &data, int next)
+template <typename ElementType, int Capacity>
+void NodePool<ElementType, Capacity>::setNode(int index, const ElementType &data, int next)
 {
     nodePool[index].data = data; // change data of node at index
     nodePool[index].next = next; // change next of node at index
 }
 
 // Definition of displayFree()
-template <typename ElementType>
-void NodePool<ElementType>::displayFree(ostream &out) const
+template <typename ElementType, int Capacity>
+void NodePool<ElementType, Capacity>::displayFree(ostream &out) const
 {
     if (freeHead == NULL_INDEX) // NodePool is full
     {
@@ -279,12 +514,12 @@ void NodePool<ElementType>::displayFree(ostream &out) const
             }
         }
     }
-    out << endl;
+    out << '\n';
 }
 
 // Definition of displayInUse()
-template <typename ElementType>
-void NodePool<ElementType>::displayInUse(ostream &out, int firstUsed) const
+template <typename ElementType, int Capacity>
+void NodePool<ElementType, Capacity>::displayInUse(ostream &out, int firstUsed) const
 {
     // Loop through the nodePool array starting from given index
     for (int i = firstUsed; i != NULL_INDEX; i = nodePool[i].next)
@@ -298,41 +533,831 @@ void NodePool<ElementType>::displayInUse(ostream &out, int firstUsed) const
 }
 
 // Definition of getNextOfNode()
-template <typename ElementType>
-int NodePool<ElementType>::getNextOfNode(int index) const
+template <typename ElementType, int Capacity>
+int NodePool<ElementType, Capacity>::getNextOfNode(int index) const
 {
     return nodePool[index].next; // Get the next of node at index
 }
 
 // Definition of setNextOfNode()
-template <typename ElementType>
-void NodePool<ElementType>::setNextOfNode(int index, int next)
+template <typename ElementType, int Capacity>
+void NodePool<ElementType, Capacity>::setNextOfNode(int index, int next)
 {
     // Set the next of node at index to next parameter
     nodePool[index].next = next;
 }
 
 // Definition of getNodeData()
-template <typename ElementType>
-ElementType NodePool<ElementType>::getNodeData(int index) const
+template <typename ElementType, int Capacity>
+ElementType NodePool<ElementType, Capacity>::getNodeData(int index) const
 {
     return nodePool[index].data; // get data of node at index
 }
 
+// Definition of nodeData()
+template <typename ElementType, int Capacity>
+const ElementType &NodePool<ElementType, Capacity>::nodeData(int index) const
+{
+    return nodePool[index].data; // reference to data of node at index
+}
+
+// Definition of nodeData() (non-const)
+template <typename ElementType, int Capacity>
+ElementType &NodePool<ElementType, Capacity>::nodeData(int index)
+{
+    return nodePool[index].data; // reference to data of node at index
+}
+
 // Definition of setNodeData()
-template <typename ElementType>
-void NodePool<ElementType>::setNodeData(int index, const ElementType &data)
+template <typename ElementType, int Capacity>
+void NodePool<ElementType, Capacity>::setNodeData(int index, const ElementType &data)
 {
     nodePool[index].data = data; // change data of node at index
 }
 
-// Definition of setNodeData()
-template <typename ElementType>
-void NodePool<ElementType>::switchOrderOfNodes(int node1, int node2)
+// Definition of indexOf()
+template <typename ElementType, int Capacity>
+int NodePool<ElementType, Capacity>::indexOf(const ElementType *data) const
+{
+    // Offset of 'data' from the data of node 0, in whole nodes (compared as
+    // integers: 'data' may point anywhere)
+    uintptr_t address = reinterpret_cast<uintptr_t>(data);
+    uintptr_t base = reinterpret_cast<uintptr_t>(&nodePool[0].data);
+    if (address < base || address - base >= sizeof(nodePool))
+        return NULL_INDEX;
+    size_t offset = address - base;
+    if (offset % sizeof(Node) != 0) // inside a node, not at its data
+        return NULL_INDEX;
+    return (int)(offset / sizeof(Node));
+}
+
+// Definition of switchOrderOfNodes()
+template <typename ElementType, int Capacity>
+void NodePool<ElementType, Capacity>::switchOrderOfNodes(int node1, int node2)
 {
     ElementType temp = nodePool[node1].data;
     nodePool[node1].data = nodePool[node2].data;
     nodePool[node2].data = temp;
 }
 
+// Definition of usedCount()
+template <typename ElementType, int Capacity>
+int NodePool<ElementType, Capacity>::usedCount() const
+{
+    return used;
+}
+
+// Definition of highWaterMark()
+template <typename ElementType, int Capacity>
+int NodePool<ElementType, Capacity>::highWaterMark() const
+{
+    return highWater;
+}
+
+// Definition of occupancy()
+template <typename ElementType, int Capacity>
+PoolStats NodePool<ElementType, Capacity>::occupancy(int firstUsed) const
+{
+    PoolStats stats = {};
+    stats.capacity = Capacity;
+    stats.used = used;
+    stats.free = Capacity - used;
+    stats.highWater = highWater;
+    stats.elementBytes = sizeof(ElementType);
+    stats.nodeBytes = sizeof(Node);
+    stats.poolBytes = sizeof(nodePool);
+    if (used > 0)
+        stats.bytesPerLiveElement = (double)sizeof(nodePool) / used;
+
+    measureLinks(*this, freeHead, firstUsed, stats);
+    return stats;
+}
+
+// Definition of capacity()
+template <typename ElementType, int Capacity>
+int NodePool<ElementType, Capacity>::capacity() const
+{
+    return Capacity;
+}
+
+// Definition of maxSize()
+template <typename ElementType, int Capacity>
+int NodePool<ElementType, Capacity>::maxSize() const
+{
+    return Capacity;
+}
+
+// Definition of measureLinks()
+template <typename Pool>
+void measureLinks(const Pool &pool, int freeHead, int firstUsed, PoolStats &stats)
+{
+    // Split the free list into runs of consecutive indices
+    int run = 0; // length of the current run
+    for (int i = freeHead; i != NULL_INDEX; i = pool.getNextOfNode(i))
+    {
+        run++;
+        if (pool.getNextOfNode(i) != i + 1) // run ends at node i
+        {
+            int bucket = 0;
+            while ((run >> (bucket + 1)) != 0)
+                bucket++;
+            stats.freeRuns[bucket]++;
+            stats.freeRunCount++;
+            if (run > stats.longestFreeRun)
+                stats.longestFreeRun = run;
+            run = 0;
+        }
+    }
+
+    // Compare the chain order with the array order
+    long long distance = 0; // sum of |next - index| over the links
+    for (int i = firstUsed; i != NULL_INDEX; i = pool.getNextOfNode(i))
+    {
+        stats.chainLength++;
+        int next = pool.getNextOfNode(i);
+        if (next == NULL_INDEX)
+            break;
+        if (next == i + 1)
+            stats.sequentialLinks++;
+        else if (next < i)
+            stats.backwardLinks++;
+        distance += next > i ? next - i : i - next;
+    }
+    if (stats.chainLength > 1)
+        stats.meanLinkDistance = (double)distance / (stats.chainLength - 1);
+}
+
+// Definition of PoolStats writeJson()
+inline void PoolStats::writeJson(ostream &out) const
+{
+    out << "{\"capacity\":" << capacity << ",\"used\":" << used
+        << ",\"free\":" << free << ",\"highWater\":" << highWater
+        << ",\"elementBytes\":" << elementBytes
+        << ",\"nodeBytes\":" << nodeBytes << ",\"poolBytes\":" << poolBytes
+        << ",\"bytesPerLiveElement\":" << bytesPerLiveElement
+        << ",\"freeRunCount\":" << freeRunCount
+        << ",\"longestFreeRun\":" << longestFreeRun << ",\"freeRuns\":[";
+    for (int bucket = 0; bucket < FREE_RUN_BUCKETS; bucket++)
+        out << (bucket > 0 ? "," : "") << freeRuns[bucket];
+    out << "],\"chainLength\":" << chainLength
+        << ",\"sequentialLinks\":" << sequentialLinks
+        << ",\"backwardLinks\":" << backwardLinks
+        << ",\"meanLinkDistance\":" << meanLinkDistance << "}\n";
+}
+
+
+/** Growable NodePool: nodes in chunks allocated on demand (see above) */
+template <typename ElementType>
+class NodePool<ElementType, GROWABLE>
+{
+private:
+    /** Private class Node */
+    class Node
+    {
+    public:
+        ElementType data; // node data
+        int next;         // index of next element in node pool
+    };
+
+public:
+    /******** Member Functions ********/
+
+    /***** Class constructors and destructor *****/
+    explicit NodePool(pmr::memory_resource *resource = pmr::get_default_resource());
+    /*--------------------------------------------------------------------------
+        Construct an empty growable NodePool.
+
+        Precondition:  'resource' outlives the pool.
+        Postcondition: The pool has no chunk; freeHead is NULL_INDEX. All its
+                       memory will come from 'resource'.
+    --------------------------------------------------------------------------*/
+
+    NodePool(const NodePool &other);
+    NodePool &operator=(const NodePool &other);
+    /*--------------------------------------------------------------------------
+        Copy a pool.
+
+        Precondition:  None.
+        Postcondition: This pool has its own copy of every chunk of 'other',
+                       so indices and links are the same in both. The copy
+                       constructor uses pmr::get_default_resource(). Throws
+                       bad_alloc if a chunk can not be allocated; an assigned
+                       pool is then unchanged.
+    --------------------------------------------------------------------------*/
+
+    NodePool(NodePool &&other) noexcept;
+    NodePool &operator=(NodePool &&other);
+    /*--------------------------------------------------------------------------
+        Move a pool.
+
+        Precondition:  None.
+        Postcondition: This pool takes over the chunks of 'other' without
+                       copying a node, so indices and links are the same;
+                       'other' is left empty, with its resource. The move
+                       constructor also takes the resource of 'other'; the
+                       assignment copies the chunks instead when the two
+                       resources are not equal.
+    --------------------------------------------------------------------------*/
+
+    pmr::memory_resource *resource() const;
+    /*--------------------------------------------------------------------------
+        Get the memory resource of the pool.
+    --------------------------------------------------------------------------*/
+
+    ~NodePool();
+    /*--------------------------------------------------------------------------
+        Free every chunk.
+    --------------------------------------------------------------------------*/
+
+    int acquireNode();
+    /*--------------------------------------------------------------------------
+        Acquire first free node from pool, growing it by one chunk if the
+        free list is empty.
+
+        Precondition:  None.
+        Postcondition: Returns the index of the node, removed from the free
+                       list, or NULL_INDEX if a chunk could not be allocated
+                       (or the pool holds MAX_GROWABLE_NODES nodes).
+    --------------------------------------------------------------------------*/
+
+    int acquireChain(int count, int &last);
+    /*--------------------------------------------------------------------------
+        Acquire the first 'count' free nodes at once, growing the pool until
+        it has that many free nodes.
+
+        Precondition:  count >= 1.
+        Postcondition: Same as the fixed pool, or returns NULL_INDEX (and
+                       acquires nothing) if the pool could not grow enough.
+    --------------------------------------------------------------------------*/
+
+    bool releaseNode(int index);
+    void releaseChain(int head, int tail, int count);
+    void setNode(int index, const ElementType &data, int next);
+    void displayFree(ostream &out) const;
+    void displayInUse(ostream &out, int firstUsed) const;
+    int getNextOfNode(int index) const;
+    void setNextOfNode(int index, int next);
+    ElementType getNodeData(int index) const;
+    const ElementType &nodeData(int index) const;
+    ElementType &nodeData(int index);
+    void setNodeData(int index, const ElementType &data);
+    void switchOrderOfNodes(int node1, int node2);
+    int usedCount() const;
+    int highWaterMark() const;
+    int maxSize() const;
+    /*--------------------------------------------------------------------------
+        Same as the fixed pool, with 0 <= index < capacity().
+    --------------------------------------------------------------------------*/
+
+    int indexOf(const ElementType *data) const;
+    /*--------------------------------------------------------------------------
+        Same as the fixed pool, but O(number of chunks).
+    --------------------------------------------------------------------------*/
+
+    void reset();
+    /*--------------------------------------------------------------------------
+        Return every node to the free list.
+
+        Precondition:  None.
+        Postcondition: The chunks are kept; the free list links 0, 1,...,
+                       capacity() - 1 in order. Any list using the pool must
+                       be emptied by its client.
+    --------------------------------------------------------------------------*/
+
+    PoolStats occupancy(int firstUsed) const;
+    /*--------------------------------------------------------------------------
+        Same as the fixed pool; poolBytes also counts the chunk directory.
+    --------------------------------------------------------------------------*/
+
+    int capacity() const;
+    /*--------------------------------------------------------------------------
+        Get the number of nodes in the pool.
+
+        Precondition:  None.
+        Postcondition: Returns the number of nodes in the allocated chunks.
+    --------------------------------------------------------------------------*/
+
+    int shrink();
+    /*--------------------------------------------------------------------------
+        Free the chunks at the end of the pool that hold no used node.
+
+        Precondition:  None.
+        Postcondition: Trailing chunks whose nodes are all free are removed
+                       from the free list and freed; other chunks, and every
+                       used index, are unchanged. Returns the number of
+                       nodes freed. One walk of the free list counts the
+                       free nodes of each chunk, and a second one (only when
+                       a chunk is freed) unlinks the nodes of freed chunks.
+    --------------------------------------------------------------------------*/
+
+private:
+    Node &node(int index);
+    const Node &node(int index) const;
+    /*--------------------------------------------------------------------------
+        Node at 'index': one directory lookup.
+    --------------------------------------------------------------------------*/
+
+    bool grow();
+    /*--------------------------------------------------------------------------
+        Allocate one more chunk and put its nodes at the front of the free
+        list, in order. Returns false if the chunk could not be allocated.
+    --------------------------------------------------------------------------*/
+
+    bool reserveChunks(size_t count);
+    /*--------------------------------------------------------------------------
+        Make room for 'count' chunks in the directory (doubling it); returns
+        false if the resource is out of memory.
+    --------------------------------------------------------------------------*/
+
+    Node *allocateChunk();
+    /*--------------------------------------------------------------------------
+        Allocate and construct CHUNK_NODES nodes from the resource; returns
+        nullptr if the resource is out of memory.
+    --------------------------------------------------------------------------*/
+
+    void copyChunks(const NodePool &other);
+    /*--------------------------------------------------------------------------
+        Copy every chunk of 'other' into this pool, which has no chunk.
+        Throws bad_alloc if one can not be allocated (or what an element
+        copy throws), with no chunk left.
+    --------------------------------------------------------------------------*/
+
+    void freeChunks(int keep);
+    /*--------------------------------------------------------------------------
+        Destroy and deallocate every chunk from chunk 'keep' on.
+    --------------------------------------------------------------------------*/
+
+    pmr::vector<Node *> chunks; // directory of chunks, CHUNK_NODES nodes each
+    int freeHead;          // Index of first free node in the linked free list
+    int used;              // Number of nodes in use
+    int highWater;         // Largest number of nodes ever in use
+
+}; // end of class declaration
+
+// Definition of growable NodePool constructor
+template <typename ElementType>
+NodePool<ElementType, GROWABLE>::NodePool(pmr::memory_resource *resource)
+    : chunks(resource), freeHead(NULL_INDEX), used(0), highWater(0) {}
+
+// Definition of growable NodePool copy constructor
+template <typename ElementType>
+NodePool<ElementType, GROWABLE>::NodePool(const NodePool &other)
+    : chunks(pmr::get_default_resource()), freeHead(NULL_INDEX), used(0),
+      highWater(0)
+{
+    copyChunks(other);
+}
+
+// Definition of growable NodePool move constructor
+template <typename ElementType>
+NodePool<ElementType, GROWABLE>::NodePool(NodePool &&other) noexcept
+    : chunks(move(other.chunks)), freeHead(other.freeHead), used(other.used),
+      highWater(other.highWater)
+{
+    other.chunks.clear();
+    other.freeHead = NULL_INDEX;
+    other.used = 0;
+    other.highWater = 0;
+}
+
+// Definition of growable resource()
+template <typename ElementType>
+pmr::memory_resource *NodePool<ElementType, GROWABLE>::resource() const
+{
+    return chunks.get_allocator().resource();
+}
+
+// Definition of growable NodePool operator=()
+template <typename ElementType>
+NodePool<ElementType, GROWABLE> &NodePool<ElementType, GROWABLE>::operator=(const NodePool &other)
+{
+    if (this == &other)
+        return *this;
+
+    // Copy aside first, so that running out of memory leaves this pool as
+    // it was
+    NodePool copy(resource());
+    copy.copyChunks(other);
+    return *this = move(copy);
+}
+
+// Definition of growable NodePool move operator=()
+template <typename ElementType>
+NodePool<ElementType, GROWABLE> &NodePool<ElementType, GROWABLE>::operator=(NodePool &&other)
+{
+    if (this == &other)
+        return *this;
+    if (!(*resource() == *other.resource())) // chunks cannot change hands
+        return *this = static_cast<const NodePool &>(other);
+
+    freeChunks(0);
+    chunks.swap(other.chunks);
+    freeHead = other.freeHead;
+    used = other.used;
+    highWater = other.highWater;
+    other.freeHead = NULL_INDEX;
+    other.used = 0;
+    other.highWater = 0;
+    return *this;
+}
+
+// Definition of growable NodePool destructor
+template <typename ElementType>
+NodePool<ElementType, GROWABLE>::~NodePool()
+{
+    freeChunks(0);
+}
+
+// Definition of growable acquireNode()
+template <typename ElementType>
+int NodePool<ElementType, GROWABLE>::acquireNode()
+{
+    if (freeHead == NULL_INDEX && !grow())
+        return NULL_INDEX; // no free nodes and no memory for more
+
+    int index = freeHead;            // take first free node
+    freeHead = node(index).next;     // move head to next free node
+    node(index).next = NULL_INDEX;   // disconnect from free list
+
+    if (++used > highWater)
+        highWater = used;
+    return index;
+}
+
+// Definition of growable acquireChain()
+template <typename ElementType>
+int NodePool<ElementType, GROWABLE>::acquireChain(int count, int &last)
+{
+    while (capacity() - used < count) // not enough free nodes yet
+    {
+        if (!grow())
+            return NULL_INDEX;
+    }
+
+    int head = freeHead; // chain starts at the first free node
+    last = head;
+    for (int i = 1; i < count; i++)
+        last = node(last).next;
+
+    freeHead = node(last).next;   // free list resumes after the chain
+    node(last).next = NULL_INDEX; // disconnect chain from free list
+
+    used += count;
+    if (used > highWater)
+        highWater = used;
+    return head;
+}
+
+// Definition of growable releaseNode()
+template <typename ElementType>
+bool NodePool<ElementType, GROWABLE>::releaseNode(int index)
+{
+    if (index < 0 || index >= capacity())
+        return false; // invalid index
+
+    // Insert node at the front of the free list
+    node(index).next = freeHead;
+    freeHead = index;
+    used--;
+    return true;
+}
+
+// Definition of growable releaseChain()
+template <typename ElementType>
+void NodePool<ElementType, GROWABLE>::releaseChain(int head, int tail, int count)
+{
+    // Insert the chain at the front of the free list
+    node(tail).next = freeHead;
+    freeHead = head;
+    used -= count;
+}
+
+// Definition of growable setNode()
+template <typename ElementType>
+void NodePool<ElementType, GROWABLE>::setNode(int index, const ElementType &data, int next)
+{
+    node(index).data = data;
+    node(index).next = next;
+}
+
+// Definition of growable displayFree()
+template <typename ElementType>
+void NodePool<ElementType, GROWABLE>::displayFree(ostream &out) const
+{
+    if (freeHead == NULL_INDEX) // every allocated node is in use
+    {
+        out << "List is full. No free nodes.";
+    }
+    else
+    {
+        out << "Free nodes: ";
+        for (int i = freeHead; i != NULL_INDEX; i = node(i).next)
+        {
+            out << i;
+            if (node(i).next != NULL_INDEX) // check if not last element
+                out << ", ";
+        }
+    }
+    out << '\n';
+}
+
+// Definition of growable displayInUse()
+template <typename ElementType>
+void NodePool<ElementType, GROWABLE>::displayInUse(ostream &out, int firstUsed) const
+{
+    for (int i = firstUsed; i != NULL_INDEX; i = node(i).next)
+    {
+        out << node(i).data;
+        if (node(i).next != NULL_INDEX) // check if not last element
+            out << ", ";
+    }
+}
+
+// Definition of growable getNextOfNode()
+template <typename ElementType>
+int NodePool<ElementType, GROWABLE>::getNextOfNode(int index) const
+{
+    return node(index).next;
+}
+
+// Definition of growable setNextOfNode()
+template <typename ElementType>
+void NodePool<ElementType, GROWABLE>::setNextOfNode(int index, int next)
+{
+    node(index).next = next;
+}
+
+// Definition of growable getNodeData()
+template <typename ElementType>
+ElementType NodePool<ElementType, GROWABLE>::getNodeData(int index) const
+{
+    return node(index).data;
+}
+
+// Definition of growable nodeData()
+template <typename ElementType>
+const ElementType &NodePool<ElementType, GROWABLE>::nodeData(int index) const
+{
+    return node(index).data;
+}
+
+// Definition of growable nodeData() (non-const)
+template <typename ElementType>
+ElementType &NodePool<ElementType, GROWABLE>::nodeData(int index)
+{
+    return node(index).data;
+}
+
+// Definition of growable setNodeData()
+template <typename ElementType>
+void NodePool<ElementType, GROWABLE>::setNodeData(int index, const ElementType &data)
+{
+    node(index).data = data;
+}
+
+// Definition of growable indexOf()
+template <typename ElementType>
+int NodePool<ElementType, GROWABLE>::indexOf(const ElementType *data) const
+{
+    uintptr_t address = reinterpret_cast<uintptr_t>(data);
+    for (size_t c = 0; c < chunks.size(); c++) // find the chunk holding data
+    {
+        uintptr_t base = reinterpret_cast<uintptr_t>(&chunks[c][0].data);
+        if (address < base || address - base >= CHUNK_NODES * sizeof(Node))
+            continue;
+        size_t offset = address - base;
+        if (offset % sizeof(Node) != 0) // inside a node, not at its data
+            return NULL_INDEX;
+        return (int)(c * CHUNK_NODES + offset / sizeof(Node));
+    }
+    return NULL_INDEX;
+}
+
+// Definition of growable switchOrderOfNodes()
+template <typename ElementType>
+void NodePool<ElementType, GROWABLE>::switchOrderOfNodes(int node1, int node2)
+{
+    ElementType temp = node(node1).data;
+    node(node1).data = node(node2).data;
+    node(node2).data = temp;
+}
+
+// Definition of growable usedCount()
+template <typename ElementType>
+int NodePool<ElementType, GROWABLE>::usedCount() const
+{
+    return used;
+}
+
+// Definition of growable highWaterMark()
+template <typename ElementType>
+int NodePool<ElementType, GROWABLE>::highWaterMark() const
+{
+    return highWater;
+}
+
+// Definition of growable maxSize()
+template <typename ElementType>
+int NodePool<ElementType, GROWABLE>::maxSize() const
+{
+    return MAX_GROWABLE_NODES;
+}
+
+// Definition of growable reset()
+template <typename ElementType>
+void NodePool<ElementType, GROWABLE>::reset()
+{
+    // Link all nodes of all chunks into a free list
+    int nodes = capacity();
+    for (int i = 0; i < nodes - 1; i++)
+        node(i).next = i + 1;
+
+    if (nodes > 0)
+        node(nodes - 1).next = NULL_INDEX;
+    freeHead = nodes > 0 ? 0 : NULL_INDEX;
+    used = 0;
+    highWater = 0;
+}
+
+// Definition of growable occupancy()
+template <typename ElementType>
+PoolStats NodePool<ElementType, GROWABLE>::occupancy(int firstUsed) const
+{
+    PoolStats stats = {};
+    stats.capacity = capacity();
+    stats.used = used;
+    stats.free = capacity() - used;
+    stats.highWater = highWater;
+    stats.elementBytes = sizeof(ElementType);
+    stats.nodeBytes = sizeof(Node);
+    stats.poolBytes = (size_t)capacity() * sizeof(Node) +
+                      chunks.capacity() * sizeof(Node *);
+    if (used > 0)
+        stats.bytesPerLiveElement = (double)stats.poolBytes / used;
+
+    measureLinks(*this, freeHead, firstUsed, stats);
+    return stats;
+}
+
+// Definition of growable capacity()
+template <typename ElementType>
+int NodePool<ElementType, GROWABLE>::capacity() const
+{
+    return (int)chunks.size() * CHUNK_NODES;
+}
+
+// Definition of growable shrink()
+template <typename ElementType>
+int NodePool<ElementType, GROWABLE>::shrink()
+{
+    // Count the free nodes of every chunk, in a table from the heap: the
+    // pool's resource may be an arena that never gives memory back
+    pmr::vector<int> freeNodes(pmr::new_delete_resource());
+    try
+    {
+        freeNodes.assign(chunks.size(), 0);
+    }
+    catch (const bad_alloc &)
+    {
+        return 0;
+    }
+    for (int i = freeHead; i != NULL_INDEX; i = node(i).next)
+        freeNodes[i >> CHUNK_SHIFT]++;
+
+    // Keep chunks up to the last one holding a used node
+    int keep = (int)chunks.size();
+    while (keep > 0 && freeNodes[keep - 1] == CHUNK_NODES)
+        keep--;
+    if (keep == (int)chunks.size()) // nothing to free
+        return 0;
+
+    // Drop the nodes of the freed chunks from the free list
+    int limit = keep * CHUNK_NODES; // first index freed
+    int *link = &freeHead;
+    while (*link != NULL_INDEX)
+    {
+        if (*link >= limit)
+            *link = node(*link).next;
+        else
+            link = &node(*link).next;
+    }
+
+    int freed = capacity() - limit;
+    freeChunks(keep);
+    return freed;
+}
+
+// Definition of growable node()
+template <typename ElementType>
+typename NodePool<ElementType, GROWABLE>::Node &NodePool<ElementType, GROWABLE>::node(int index)
+{
+    return chunks[index >> CHUNK_SHIFT][index & (CHUNK_NODES - 1)];
+}
+
+// Definition of growable node() (const)
+template <typename ElementType>
+const typename NodePool<ElementType, GROWABLE>::Node &
+NodePool<ElementType, GROWABLE>::node(int index) const
+{
+    return chunks[index >> CHUNK_SHIFT][index & (CHUNK_NODES - 1)];
+}
+
+// Definition of grow()
+template <typename ElementType>
+bool NodePool<ElementType, GROWABLE>::grow()
+{
+    if (capacity() == MAX_GROWABLE_NODES) // no more indices
+        return false;
+
+    if (!reserveChunks(chunks.size() + 1))
+        return false;
+    Node *chunk = allocateChunk();
+    if (chunk == nullptr)
+        return false;
+
+    // Thread the new nodes, in order, in front of the free list
+    int base = capacity(); // index of the first new node
+    for (int i = 0; i < CHUNK_NODES - 1; i++)
+        chunk[i].next = base + i + 1;
+    chunk[CHUNK_NODES - 1].next = freeHead;
+    chunks.push_back(chunk);
+    freeHead = base;
+    return true;
+}
+
+// Definition of reserveChunks()
+template <typename ElementType>
+bool NodePool<ElementType, GROWABLE>::reserveChunks(size_t count)
+{
+    if (count <= chunks.capacity())
+        return true;
+    try
+    {
+        chunks.reserve(max(count, 2 * chunks.capacity()));
+    }
+    catch (const bad_alloc &) // memory_resource reports failure by throwing
+    {
+        return false;
+    }
+    return true;
+}
+
+// Definition of allocateChunk()
+template <typename ElementType>
+typename NodePool<ElementType, GROWABLE>::Node *NodePool<ElementType, GROWABLE>::allocateChunk()
+{
+    void *memory;
+    try
+    {
+        memory = resource()->allocate(CHUNK_NODES * sizeof(Node), alignof(Node));
+    }
+    catch (const bad_alloc &) // memory_resource reports failure by throwing
+    {
+        return nullptr;
+    }
+    Node *chunk = static_cast<Node *>(memory);
+    for (int i = 0; i < CHUNK_NODES; i++)
+        new (&chunk[i]) Node();
+    return chunk;
+}
+
+// Definition of copyChunks()
+template <typename ElementType>
+void NodePool<ElementType, GROWABLE>::copyChunks(const NodePool &other)
+{
+    try
+    {
+        for (size_t c = 0; c < other.chunks.size(); c++)
+        {
+            Node *chunk = reserveChunks(c + 1) ? allocateChunk() : nullptr;
+            if (chunk == nullptr)
+                throw bad_alloc();
+            chunks.push_back(chunk); // room reserved, can not throw
+            for (int i = 0; i < CHUNK_NODES; i++)
+                chunk[i] = other.chunks[c][i];
+        }
+    }
+    catch (...) // out of memory, or an element copy threw: drop the copy
+    {
+        freeChunks(0);
+        throw;
+    }
+    freeHead = other.freeHead;
+    used = other.used;
+    highWater = other.highWater;
+}
+
+// Definition of freeChunks()
+template <typename ElementType>
+void NodePool<ElementType, GROWABLE>::freeChunks(int keep)
+{
+    for (size_t c = keep; c < chunks.size(); c++)
+    {
+        for (int i = 0; i < CHUNK_NODES; i++)
+            chunks[c][i].~Node();
+        resource()->deallocate(chunks[c], CHUNK_NODES * sizeof(Node), alignof(Node));
+    }
+    chunks.resize(keep);
+}
+
 #endif
@@ -0,0 +1,314 @@
+/*-- NodePoolResource.h --------------------------------------------------------
+    This header file defines NodePoolResource, a std::pmr::memory_resource
+    that carves single-object allocations out of a NodePool, and
+    NodePoolAllocator, a standard allocator built on it.
+
+    The free list of a NodePool is an O(1) fixed-size slab allocator: each
+    node holds one Slot of SlotSize bytes, acquireNode hands one out and
+    releaseNode takes it back. NodePoolResource exposes that to other
+    containers, so the nodes of std::list, std::map, std::unordered_map
+    (through std::pmr containers or NodePoolAllocator) come from the pool
+    instead of malloc. An allocation is served by the pool if it fits a
+    Slot; larger or over-aligned allocations (such as the bucket array of an
+    unordered_map), and allocations made while the pool is full, go to an
+    upstream resource. Deallocation finds the node of a pointer in O(1)
+    with NodePool::indexOf.
+
+    Basic operations are:
+        Constructor: Constructs a resource over an empty pool.
+        allocate / deallocate: (std::pmr::memory_resource) Get or return
+                               memory.
+        upstream: Returns the resource used for what the pool can not serve.
+        usedCount: Returns the number of slots in use.
+        overflowCount: Returns the number of allocations sent upstream.
+        poolStats: Report occupancy and fragmentation of the NodePool.
+
+    SlotSize is the largest allocation the pool serves; slots are aligned
+    for any scalar type (alignof(max_align_t)). Capacity is the number of
+    slots; it must be fixed (not GROWABLE), so the pool is one array and a
+    pointer maps to its slot in O(1). The resource can not be copied: live
+    allocations point into it.
+------------------------------------------------------------------------------*/
+
+#ifndef NODEPOOLRESOURCE_H
+#define NODEPOOLRESOURCE_H
+
+#include <cstddef>
+#include <memory_resource>
+#include <new>
+#include "NodePool.h"
+
+using namespace std;
+
+template <size_t SlotSize, int Capacity = CAPACITY>
+class NodePoolResource : public pmr::memory_resource
+{
+    static_assert(Capacity != GROWABLE, "NodePoolResource needs a fixed Capacity");
+
+public:
+    /** Public class Slot: data of a pool node */
+    class Slot
+    {
+    public:
+        alignas(max_align_t) unsigned char bytes[SlotSize]; // one object
+    };
+
+    /******** Member Functions ********/
+
+    /***** Class constructor *****/
+    explicit NodePoolResource(pmr::memory_resource *upstream = pmr::get_default_resource());
+    /*--------------------------------------------------------------------------
+        Construct a NodePoolResource.
+
+        Precondition:  'upstream' outlives the resource.
+        Postcondition: Every slot is free; allocations the pool can not serve
+                       go to 'upstream'.
+    --------------------------------------------------------------------------*/
+
+    NodePoolResource(const NodePoolResource &) = delete;
+    NodePoolResource &operator=(const NodePoolResource &) = delete;
+
+    pmr::memory_resource *upstream() const;
+    /*--------------------------------------------------------------------------
+        Get the upstream resource.
+    --------------------------------------------------------------------------*/
+
+    int usedCount() const;
+    /*--------------------------------------------------------------------------
+        Get the number of slots allocated and not yet deallocated, in O(1).
+    --------------------------------------------------------------------------*/
+
+    long long overflowCount() const;
+    /*--------------------------------------------------------------------------
+        Get the number of allocations that did not fit a slot or found the
+        pool full, and were sent upstream.
+    --------------------------------------------------------------------------*/
+
+    PoolStats poolStats() const;
+    /*--------------------------------------------------------------------------
+        Report the occupancy and fragmentation of the NodePool.
+
+        Precondition:  None.
+        Postcondition: Returns NodePool::occupancy() with no chain.
+    --------------------------------------------------------------------------*/
+
+protected:
+    void *do_allocate(size_t bytes, size_t alignment) override;
+    /*--------------------------------------------------------------------------
+        Allocate memory for one object.
+
+        Precondition:  None.
+        Postcondition: Returns a free slot if bytes <= SlotSize and
+                       alignment <= alignof(Slot) and the pool is not full,
+                       in O(1); otherwise returns upstream()->allocate()
+                       (which throws bad_alloc on failure).
+    --------------------------------------------------------------------------*/
+
+    void do_deallocate(void *pointer, size_t bytes, size_t alignment) override;
+    /*--------------------------------------------------------------------------
+        Return memory obtained from allocate().
+
+        Precondition:  'pointer' was returned by allocate(bytes, alignment)
+                       of this resource and not yet deallocated.
+        Postcondition: A slot is released to the pool, in O(1); other
+                       memory is returned upstream.
+    --------------------------------------------------------------------------*/
+
+    bool do_is_equal(const pmr::memory_resource &other) const noexcept override;
+    /*--------------------------------------------------------------------------
+        Returns true only for this very resource.
+    --------------------------------------------------------------------------*/
+
+private:
+    NodePool<Slot, Capacity> pool;         // slots
+    pmr::memory_resource *upstreamResource; // memory the pool can not serve
+    long long overflows;                    // allocations sent upstream
+};
+
+template <typename T, size_t SlotSize, int Capacity = CAPACITY>
+class NodePoolAllocator
+{
+public:
+    typedef T value_type;
+
+    template <typename U>
+    class rebind
+    {
+    public:
+        typedef NodePoolAllocator<U, SlotSize, Capacity> other;
+    };
+
+    /******** Member Functions ********/
+
+    /***** Class constructors *****/
+    NodePoolAllocator(NodePoolResource<SlotSize, Capacity> &resource);
+    /*--------------------------------------------------------------------------
+        Construct an allocator drawing from 'resource'.
+
+        Precondition:  'resource' outlives every container using the
+                       allocator.
+        Postcondition: The allocator refers to 'resource'.
+    --------------------------------------------------------------------------*/
+
+    template <typename U>
+    NodePoolAllocator(const NodePoolAllocator<U, SlotSize, Capacity> &other);
+    /*--------------------------------------------------------------------------
+        Construct an allocator for another type drawing from the same
+        resource (used by containers to allocate their nodes).
+    --------------------------------------------------------------------------*/
+
+    T *allocate(size_t count);
+    /*--------------------------------------------------------------------------
+        Allocate memory for 'count' objects of type T.
+
+        Precondition:  None.
+        Postcondition: Returns the memory; a single node-sized object comes
+                       from a slot. Throws bad_alloc on failure, as required
+                       of an allocator.
+    --------------------------------------------------------------------------*/
+
+    void deallocate(T *pointer, size_t count);
+    /*--------------------------------------------------------------------------
+        Return memory obtained from allocate(count).
+    --------------------------------------------------------------------------*/
+
+    NodePoolResource<SlotSize, Capacity> *resource() const;
+    /*--------------------------------------------------------------------------
+        Get the resource of the allocator.
+    --------------------------------------------------------------------------*/
+
+private:
+    NodePoolResource<SlotSize, Capacity> *poolResource; // memory source
+};
+
+template <typename T, typename U, size_t SlotSize, int Capacity>
+bool operator==(const NodePoolAllocator<T, SlotSize, Capacity> &a,
+                const NodePoolAllocator<U, SlotSize, Capacity> &b);
+template <typename T, typename U, size_t SlotSize, int Capacity>
+bool operator!=(const NodePoolAllocator<T, SlotSize, Capacity> &a,
+                const NodePoolAllocator<U, SlotSize, Capacity> &b);
+/*------------------------------------------------------------------------------
+    Allocators are equal when they draw from the same resource.
+------------------------------------------------------------------------------*/
+
+/**************** FUNCTION DEFINITIONS ****************************************/
+
+// Definition of NodePoolResource constructor
+template <size_t SlotSize, int Capacity>
+NodePoolResource<SlotSize, Capacity>::NodePoolResource(pmr::memory_resource *upstream)
+    : upstreamResource(upstream), overflows(0) {}
+
+// Definition of upstream()
+template <size_t SlotSize, int Capacity>
+pmr::memory_resource *NodePoolResource<SlotSize, Capacity>::upstream() const
+{
+    return upstreamResource;
+}
+
+// Definition of usedCount()
+template <size_t SlotSize, int Capacity>
+int NodePoolResource<SlotSize, Capacity>::usedCount() const
+{
+    return pool.usedCount();
+}
+
+// Definition of overflowCount()
+template <size_t SlotSize, int Capacity>
+long long NodePoolResource<SlotSize, Capacity>::overflowCount() const
+{
+    return overflows;
+}
+
+// Definition of poolStats()
+template <size_t SlotSize, int Capacity>
+PoolStats NodePoolResource<SlotSize, Capacity>::poolStats() const
+{
+    return pool.occupancy(NULL_INDEX);
+}
+
+// Definition of do_allocate()
+template <size_t SlotSize, int Capacity>
+void *NodePoolResource<SlotSize, Capacity>::do_allocate(size_t bytes, size_t alignment)
+{
+    if (bytes <= SlotSize && alignment <= alignof(Slot))
+    {
+        int index = pool.acquireNode();
+        if (index != NULL_INDEX)
+            return pool.nodeData(index).bytes;
+    }
+    overflows++; // too big, over-aligned or pool full
+    return upstreamResource->allocate(bytes, alignment);
+}
+
+// Definition of do_deallocate()
+template <size_t SlotSize, int Capacity>
+void NodePoolResource<SlotSize, Capacity>::do_deallocate(void *pointer, size_t bytes,
+                                                          size_t alignment)
+{
+    int index = pool.indexOf(static_cast<const Slot *>(pointer));
+    if (index != NULL_INDEX)
+        pool.releaseNode(index);
+    else
+        upstreamResource->deallocate(pointer, bytes, alignment);
+}
+
+// Definition of do_is_equal()
+template <size_t SlotSize, int Capacity>
+bool NodePoolResource<SlotSize, Capacity>::do_is_equal(const pmr::memory_resource &other) const noexcept
+{
+    return this == &other;
+}
+
+// Definition of NodePoolAllocator constructor
+template <typename T, size_t SlotSize, int Capacity>
+NodePoolAllocator<T, SlotSize, Capacity>::NodePoolAllocator(
+    NodePoolResource<SlotSize, Capacity> &resource)
+    : poolResource(&resource) {}
+
+// Definition of NodePoolAllocator converting constructor
+template <typename T, size_t SlotSize, int Capacity>
+template <typename U>
+NodePoolAllocator<T, SlotSize, Capacity>::NodePoolAllocator(
+    const NodePoolAllocator<U, SlotSize, Capacity> &other)
+    : poolResource(other.resource()) {}
+
+// Definition of NodePoolAllocator allocate()
+template <typename T, size_t SlotSize, int Capacity>
+T *NodePoolAllocator<T, SlotSize, Capacity>::allocate(size_t count)
+{
+    if (count > (size_t)-1 / sizeof(T)) // size does not fit a size_t
+        throw bad_array_new_length();
+    return static_cast<T *>(poolResource->allocate(count * sizeof(T), alignof(T)));
+}
+
+// Definition of NodePoolAllocator deallocate()
+template <typename T, size_t SlotSize, int Capacity>
+void NodePoolAllocator<T, SlotSize, Capacity>::deallocate(T *pointer, size_t count)
+{
+    poolResource->deallocate(pointer, count * sizeof(T), alignof(T));
+}
+
+// Definition of NodePoolAllocator resource()
+template <typename T, size_t SlotSize, int Capacity>
+NodePoolResource<SlotSize, Capacity> *NodePoolAllocator<T, SlotSize, Capacity>::resource() const
+{
+    return poolResource;
+}
+
+// Definition of operator==()
+template <typename T, typename U, size_t SlotSize, int Capacity>
+bool operator==(const NodePoolAllocator<T, SlotSize, Capacity> &a,
+                const NodePoolAllocator<U, SlotSize, Capacity> &b)
+{
+    return a.resource() == b.resource();
+}
+
+// Definition of operator!=()
+template <typename T, typename U, size_t SlotSize, int Capacity>
+bool operator!=(const NodePoolAllocator<T, SlotSize, Capacity> &a,
+                const NodePoolAllocator<U, SlotSize, Capacity> &b)
+{
+    return a.resource() != b.resource();
+}
+
+#endif
@@ -0,0 +1,337 @@
+/*-- PersistentList.h ----------------------------------------------------------
+    This header file defines the template class PersistentList, which keeps an
+    ArrayBasedList inside a memory-mapped file.
+
+    Nodes refer to each other by index, so an ArrayBasedList of trivially
+    copyable elements (its node array, freeHead and first) does not depend on
+    the address it lives at. The file holds a small header followed by the raw
+    image of the list, and opening an existing file only maps it: the list is
+    usable immediately, with no deserialization.
+
+    File layout:
+        offset 0:                 ListImageHeader
+        offset LIST_IMAGE_OFFSET: ArrayBasedList<ElementType, Capacity> image
+
+    Basic operations are:
+        Constructor: Constructs a PersistentList with no file open.
+        Destructor: Unmaps and closes the file.
+        open: Map an existing list file, or create and map a new one.
+        close: Unmap and close the file.
+        sync: Flush the mapped list to the file.
+        isOpen: Check if a file is mapped.
+        list: Access the mapped ArrayBasedList.
+
+    Helper functions (also used by other mapped list types):
+        initListImageHeader: Fill in a header for a list type.
+        validListImageHeader: Check a header against a list type.
+------------------------------------------------------------------------------*/
+
+#ifndef PERSISTENTLIST_H
+#define PERSISTENTLIST_H
+
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "ArrayBasedList.h"
+
+using namespace std;
+
+const char LIST_IMAGE_MAGIC[8] = {'A', 'B', 'L', 'I', 'S', 'T', '\0', '\0'};
+const uint32_t LIST_IMAGE_VERSION = 1;
+const size_t LIST_IMAGE_OFFSET = 64; // list image starts after the header
+
+/** Header stored at the start of a mapped list file */
+struct ListImageHeader
+{
+    char magic[8];        // LIST_IMAGE_MAGIC
+    uint32_t version;     // LIST_IMAGE_VERSION
+    uint32_t elementSize; // sizeof(ElementType)
+    int32_t capacity;     // number of nodes in the pool
+    uint32_t imageSize;   // sizeof(ArrayBasedList<ElementType, Capacity>)
+};
+
+static_assert(sizeof(ListImageHeader) <= LIST_IMAGE_OFFSET,
+              "ListImageHeader must fit before the list image");
+
+template <typename ElementType, int Capacity>
+void initListImageHeader(ListImageHeader &header);
+/*------------------------------------------------------------------------------
+    Fill in a header describing ArrayBasedList<ElementType, Capacity>.
+
+    Precondition:  None.
+    Postcondition: header holds the magic, version, element size, capacity and
+                   image size of the list type.
+------------------------------------------------------------------------------*/
+
+template <typename ElementType, int Capacity>
+bool validListImageHeader(const ListImageHeader &header);
+/*------------------------------------------------------------------------------
+    Check that a header describes ArrayBasedList<ElementType, Capacity>.
+
+    Precondition:  None.
+    Postcondition: Returns true if every field of header matches the list
+                   type, false otherwise.
+------------------------------------------------------------------------------*/
+
+template <typename ElementType, int Capacity = CAPACITY>
+class PersistentList
+{
+    static_assert(is_trivially_copyable<ElementType>::value,
+                  "PersistentList requires a trivially copyable ElementType");
+    static_assert(Capacity != GROWABLE,
+                  "PersistentList requires a fixed Capacity (no heap chunks)");
+
+public:
+    typedef ArrayBasedList<ElementType, Capacity> ListType;
+
+    /******** Member Functions ********/
+
+    /***** Class constructor *****/
+    PersistentList();
+    /*--------------------------------------------------------------------------
+        Construct a PersistentList with no file open.
+
+        Precondition:  None.
+        Postcondition: isOpen() returns false.
+    --------------------------------------------------------------------------*/
+
+    /***** Class destructor *****/
+    ~PersistentList();
+    /*--------------------------------------------------------------------------
+        Unmap and close the file, if one is open.
+
+        Precondition:  None.
+        Postcondition: The mapping is released; changes already written to the
+                       mapping are kept by the operating system.
+    --------------------------------------------------------------------------*/
+
+    PersistentList(const PersistentList &) = delete;
+    PersistentList &operator=(const PersistentList &) = delete;
+
+    bool open(const char *path);
+    /*--------------------------------------------------------------------------
+        Map the list file at path.
+
+        Precondition:  No file is open.
+        Postcondition: If the file does not exist (or is empty, or was sized
+                       but never stamped because creating it was cut short),
+                       it is created with an empty list. If it exists, its
+                       header is checked
+                       against this list type and the list is mapped as is.
+                       Returns true on success, false if the file can not be
+                       created or mapped, or its header does not match.
+    --------------------------------------------------------------------------*/
+
+    void close();
+    /*--------------------------------------------------------------------------
+        Unmap and close the file.
+
+        Precondition:  None.
+        Postcondition: isOpen() returns false.
+    --------------------------------------------------------------------------*/
+
+    bool sync();
+    /*--------------------------------------------------------------------------
+        Flush the mapped list to the file.
+
+        Precondition:  A file is open.
+        Postcondition: Returns true once the whole mapping has been written to
+                       stable storage, false on failure.
+    --------------------------------------------------------------------------*/
+
+    bool isOpen() const;
+    /*--------------------------------------------------------------------------
+        Check if a file is mapped.
+
+        Precondition:  None.
+        Postcondition: Returns true if a file is open, false otherwise.
+    --------------------------------------------------------------------------*/
+
+    ListType &list();
+    /*--------------------------------------------------------------------------
+        Access the mapped list.
+
+        Precondition:  A file is open.
+        Postcondition: Returns the list stored in the file; every change made
+                       through it goes directly to the mapping.
+    --------------------------------------------------------------------------*/
+
+    static size_t fileSize();
+    /*--------------------------------------------------------------------------
+        Size in bytes of a list file for this list type.
+
+        Precondition:  None.
+        Postcondition: Returns LIST_IMAGE_OFFSET plus the size of the list.
+    --------------------------------------------------------------------------*/
+
+private:
+    int fd;          // file descriptor of the open file, or -1
+    void *mapping;   // start of the mapped file, or nullptr
+    ListType *image; // list stored in the mapping
+
+}; // end of class declaration
+
+/**************** FUNCTION DEFINITIONS ****************************************/
+
+// Definition of initListImageHeader()
+template <typename ElementType, int Capacity>
+void initListImageHeader(ListImageHeader &header)
+{
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, LIST_IMAGE_MAGIC, sizeof(header.magic));
+    header.version = LIST_IMAGE_VERSION;
+    header.elementSize = sizeof(ElementType);
+    header.capacity = Capacity;
+    header.imageSize = sizeof(ArrayBasedList<ElementType, Capacity>);
+}
+
+// Definition of validListImageHeader()
+template <typename ElementType, int Capacity>
+bool validListImageHeader(const ListImageHeader &header)
+{
+    ListImageHeader expected; // header this list type would write
+    initListImageHeader<ElementType, Capacity>(expected);
+
+    return memcmp(header.magic, expected.magic, sizeof(header.magic)) == 0 &&
+           header.version == expected.version &&
+           header.elementSize == expected.elementSize &&
+           header.capacity == expected.capacity &&
+           header.imageSize == expected.imageSize;
+}
+
+// Definition of constructor
+template <typename ElementType, int Capacity>
+PersistentList<ElementType, Capacity>::PersistentList()
+    : fd(-1), mapping(nullptr), image(nullptr) {}
+
+// Definition of destructor
+template <typename ElementType, int Capacity>
+PersistentList<ElementType, Capacity>::~PersistentList()
+{
+    close();
+}
+
+// Definition of open()
+template <typename ElementType, int Capacity>
+bool PersistentList<ElementType, Capacity>::open(const char *path)
+{
+    if (isOpen()) // already mapped
+        return false;
+
+    fd = ::open(path, O_RDWR | O_CREAT, 0644);
+    if (fd < 0)
+        return false;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0)
+    {
+        close();
+        return false;
+    }
+
+    bool created = info.st_size == 0; // new file, list must be constructed
+    if (created)
+    {
+        if (ftruncate(fd, fileSize()) != 0)
+        {
+            close();
+            return false;
+        }
+    }
+    else if ((size_t)info.st_size != fileSize()) // not a file of this type
+    {
+        close();
+        return false;
+    }
+
+    mapping = mmap(nullptr, fileSize(), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED)
+    {
+        mapping = nullptr;
+        close();
+        return false;
+    }
+
+    ListImageHeader *header = static_cast<ListImageHeader *>(mapping);
+    void *listAddress = static_cast<char *>(mapping) + LIST_IMAGE_OFFSET;
+
+    // A crash after sizing a new file but before stamping its header leaves
+    // an all-zero header: finish creating it
+    static const ListImageHeader unstamped = {};
+    if (memcmp(header, &unstamped, sizeof(ListImageHeader)) == 0)
+        created = true;
+
+    if (created)
+    {
+        // Build an empty list in place and write it out, then stamp the
+        // header, so a stamped header is never followed by an unbuilt list
+        image = new (listAddress) ListType();
+        if (msync(mapping, fileSize(), MS_SYNC) != 0)
+        {
+            close();
+            return false;
+        }
+        initListImageHeader<ElementType, Capacity>(*header);
+    }
+    else
+    {
+        if (!validListImageHeader<ElementType, Capacity>(*header))
+        {
+            close();
+            return false;
+        }
+        // The bytes already form a list; no construction or copying needed
+        image = std::launder(static_cast<ListType *>(listAddress));
+    }
+    return true;
+}
+
+// Definition of close()
+template <typename ElementType, int Capacity>
+void PersistentList<ElementType, Capacity>::close()
+{
+    if (mapping != nullptr)
+        munmap(mapping, fileSize());
+    if (fd >= 0)
+        ::close(fd);
+
+    fd = -1;
+    mapping = nullptr;
+    image = nullptr;
+}
+
+// Definition of sync()
+template <typename ElementType, int Capacity>
+bool PersistentList<ElementType, Capacity>::sync()
+{
+    return mapping != nullptr && msync(mapping, fileSize(), MS_SYNC) == 0;
+}
+
+// Definition of isOpen()
+template <typename ElementType, int Capacity>
+bool PersistentList<ElementType, Capacity>::isOpen() const
+{
+    return mapping != nullptr;
+}
+
+// Definition of list()
+template <typename ElementType, int Capacity>
+typename PersistentList<ElementType, Capacity>::ListType &
+PersistentList<ElementType, Capacity>::list()
+{
+    return *image;
+}
+
+// Definition of fileSize()
+template <typename ElementType, int Capacity>
+size_t PersistentList<ElementType, Capacity>::fileSize()
+{
+    return LIST_IMAGE_OFFSET + sizeof(ListType);
+}
+
+#endif
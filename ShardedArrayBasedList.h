@@ -0,0 +1,645 @@
+/*-- ShardedArrayBasedList.h ---------------------------------------------------
+    This header file defines the template class ShardedArrayBasedList, one
+    logical list partitioned into shards, each an ArrayBasedList with its
+    own NodePool, so bulk operations run on every shard in parallel.
+
+    The list is the concatenation of its shards, in shard order. A directory
+    of shard sizes maps a position to its shard (one step per shard), so
+    positional operations touch a single shard. Bulk operations (search,
+    count, sort, removeIf) start one std::thread per shard, and each works
+    only on its own shard and pool, so they need no lock.
+
+    Basic operations are:
+        Constructor: Constructs an empty list with some shards.
+        assign: Replace the content, spread evenly over the shards.
+        isEmpty: Check if list is empty.
+        insertAtPosition: Insert an element at a position (one shard).
+        deleteAtPosition: Delete the element at a position (one shard).
+        append: Insert an element at the end (last shard).
+        search: Search for a value (parallel).
+        count: Count the occurrences of a value (parallel).
+        removeIf: Remove every element satisfying a predicate (parallel).
+        sort: Sort the list in ascending order (parallel).
+        rebalance: Spread the elements evenly over the shards again.
+        size: Returns the size of the list, from the directory.
+        shardCount / shardSize: Describe the partition.
+        display: Print list content.
+        clear: Remove every element from the list.
+
+    const_iterator (nested class) walks the whole list in order, read-only.
+
+    Capacity is a template parameter giving the number of nodes of each
+    shard's NodePool; the default, GROWABLE, lets every shard grow (see
+    NodePool.h). The number of shards is chosen at construction, by default
+    one per hardware thread. Programs using the parallel operations must be
+    linked with -pthread.
+
+    Class Invariant:
+        1. sizes[s] is the number of elements of shards[s].
+        2. Element i of the list is element i - (sizes[0] + ... + sizes[s-1])
+           of the shard s holding it.
+------------------------------------------------------------------------------*/
+
+#ifndef SHARDEDARRAYBASEDLIST_H
+#define SHARDEDARRAYBASEDLIST_H
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <queue>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "ArrayBasedList.h"
+
+using namespace std;
+
+template <typename ElementType, int Capacity = GROWABLE>
+class ShardedArrayBasedList
+{
+public:
+    typedef ArrayBasedList<ElementType, Capacity> Shard;
+
+    /** Public class const_iterator */
+    class const_iterator
+    {
+    public:
+        typedef forward_iterator_tag iterator_category;
+        typedef ElementType value_type;
+        typedef ptrdiff_t difference_type;
+        typedef const ElementType *pointer;
+        typedef const ElementType &reference;
+
+        /******** Member Functions ********/
+
+        /***** Class constructor *****/
+        const_iterator();
+        /*----------------------------------------------------------------------
+            Construct an iterator equal to end() of any list.
+        ----------------------------------------------------------------------*/
+
+        reference operator*() const;
+        pointer operator->() const;
+        const_iterator &operator++();
+        const_iterator operator++(int);
+        bool operator==(const const_iterator &other) const;
+        bool operator!=(const const_iterator &other) const;
+        /*----------------------------------------------------------------------
+            Same as ArrayBasedList::const_iterator; ++ moves on to the first
+            element of the next non-empty shard at the end of a shard.
+        ----------------------------------------------------------------------*/
+
+    private:
+        friend class ShardedArrayBasedList;
+        const_iterator(const ShardedArrayBasedList *list, int shard);
+        void skipEmptyShards();
+
+        /******** Data members ********/
+        const ShardedArrayBasedList *list;   // list walked
+        int shard;                           // current shard, or NULL_INDEX at end
+        typename Shard::const_iterator node; // current element in the shard
+    };
+
+    /******** Member Functions ********/
+
+    /***** Class constructor *****/
+    explicit ShardedArrayBasedList(int shardCount = defaultThreadCount());
+    /*--------------------------------------------------------------------------
+        Construct an empty ShardedArrayBasedList.
+
+        Precondition:  shardCount >= 1.
+        Postcondition: The list has 'shardCount' empty shards.
+    --------------------------------------------------------------------------*/
+
+    template <typename ForwardIterator>
+    int assign(ForwardIterator rangeBegin, ForwardIterator rangeEnd);
+    /*--------------------------------------------------------------------------
+        Replace the content of the list with a range.
+
+        Precondition:  ForwardIterator is a forward iterator over ElementType.
+        Postcondition: The list holds the elements in order; shard s holds
+                       the s-th of shardCount() nearly equal slices, filled
+                       in parallel. Returns the number of elements stored
+                       (fewer if a fixed-Capacity shard is full).
+    --------------------------------------------------------------------------*/
+
+    bool isEmpty() const;
+    /*--------------------------------------------------------------------------
+        Check if the list is empty, in O(shards).
+    --------------------------------------------------------------------------*/
+
+    bool insertAtPosition(const ElementType &value, int position);
+    /*--------------------------------------------------------------------------
+        Insert a new element at a specified position in the list.
+
+        Precondition:  0 <= position <= size().
+        Postcondition: 'value' is inserted at 'position' and true is returned;
+                       false if position is invalid or the shard is full. A
+                       position between two shards goes to the smaller one.
+------------------------------------------------------------------------------*/
+
+    bool deleteAtPosition(int position);
+    /*--------------------------------------------------------------------------
+        Delete the element at the specified position in the list.
+
+        Precondition:  0 <= position < size().
+        Postcondition: The element is removed from its shard and true is
+                       returned; false if position is invalid.
+------------------------------------------------------------------------------*/
+
+    bool append(const ElementType &value);
+    /*--------------------------------------------------------------------------
+        Insert an element at the end of the list (in the last shard).
+
+        Precondition:  None.
+        Postcondition: Returns true, or false if the last shard is full.
+------------------------------------------------------------------------------*/
+
+    int search(const ElementType &data) const;
+    /*--------------------------------------------------------------------------
+        Search for the first occurrence of a value in the list.
+
+        Precondition:  None
+        Postcondition: Returns the position of the first element equal to
+                       'data', or NULL_INDEX; all shards are searched in
+                       parallel.
+------------------------------------------------------------------------------*/
+
+    int count(const ElementType &data) const;
+    /*--------------------------------------------------------------------------
+        Count the elements equal to a value.
+
+        Precondition:  None
+        Postcondition: Returns the count, all shards counted in parallel.
+------------------------------------------------------------------------------*/
+
+    template <typename Predicate>
+    int removeIf(Predicate predicate);
+    /*--------------------------------------------------------------------------
+        Remove every element for which a predicate returns true.
+
+        Precondition:  predicate(element) may be called from several threads
+                       at once.
+        Postcondition: Same as ArrayBasedList::removeIf() on every shard, in
+                       parallel. Returns the number of elements removed.
+------------------------------------------------------------------------------*/
+
+    void sort();
+    /*--------------------------------------------------------------------------
+        Sorts the list in ascending order.
+
+        Precondition:  ElementType supports operator>.
+        Postcondition: Every shard is sorted in parallel (O(n/k log(n/k))),
+                       the k sorted shards are merged (O(n log k)), and the
+                       result is spread evenly over the shards in parallel.
+------------------------------------------------------------------------------*/
+
+    void rebalance();
+    /*--------------------------------------------------------------------------
+        Spread the elements evenly over the shards.
+
+        Precondition:  None.
+        Postcondition: Same order; shard s holds the s-th of shardCount()
+                       nearly equal slices.
+------------------------------------------------------------------------------*/
+
+    int size() const;
+    /*--------------------------------------------------------------------------
+        Returns the size of the list, adding the directory's sizes.
+------------------------------------------------------------------------------*/
+
+    int shardCount() const;
+    int shardSize(int shard) const;
+    /*--------------------------------------------------------------------------
+        Get the number of shards / the number of elements of a shard.
+
+        Precondition:  0 <= shard < shardCount().
+------------------------------------------------------------------------------*/
+
+    void display(ostream &out) const;
+    /*--------------------------------------------------------------------------
+        Display all elements in the list in order.
+
+        Precondition:  None
+        Postcondition: Outputs all elements, separated by ", ", to 'out', or
+                       "List is empty", followed by '\n'.
+------------------------------------------------------------------------------*/
+
+    void clear();
+    /*--------------------------------------------------------------------------
+        Remove every element from every shard.
+------------------------------------------------------------------------------*/
+
+    const_iterator begin() const;
+    const_iterator end() const;
+    /*--------------------------------------------------------------------------
+        Get an iterator to the first element / the past-the-end iterator.
+------------------------------------------------------------------------------*/
+
+private:
+    void forEachShard(const function<void(int)> &task) const;
+    /*--------------------------------------------------------------------------
+        Run task(s) for every shard s, one thread per shard (the calling
+        thread takes shard 0), and wait for all of them.
+------------------------------------------------------------------------------*/
+
+    int locate(int &position, bool inserting) const;
+    /*--------------------------------------------------------------------------
+        Find the shard of a position.
+
+        Precondition:  0 <= position (< size(), or <= size() if inserting).
+        Postcondition: Returns the shard and turns 'position' into a position
+                       in it, or returns NULL_INDEX if position is too big.
+------------------------------------------------------------------------------*/
+
+    void distribute(const vector<ElementType> &elements);
+    /*--------------------------------------------------------------------------
+        Replace the content of every shard with its even slice of
+        'elements', in parallel.
+------------------------------------------------------------------------------*/
+
+    vector<Shard> shards; // the partition, in list order
+    vector<int> sizes;    // directory: number of elements of each shard
+
+}; // end of class declaration
+
+/**************** FUNCTION DEFINITIONS ****************************************/
+
+// Definition of const_iterator no-arg constructor
+template <typename ElementType, int Capacity>
+ShardedArrayBasedList<ElementType, Capacity>::const_iterator::const_iterator()
+    : list(nullptr), shard(NULL_INDEX) {}
+
+// Definition of const_iterator constructor with list and shard
+template <typename ElementType, int Capacity>
+ShardedArrayBasedList<ElementType, Capacity>::const_iterator::const_iterator(
+    const ShardedArrayBasedList *list, int shard)
+    : list(list), shard(shard)
+{
+    if (shard != NULL_INDEX)
+    {
+        node = list->shards[shard].begin();
+        skipEmptyShards();
+    }
+}
+
+// Definition of const_iterator skipEmptyShards()
+template <typename ElementType, int Capacity>
+void ShardedArrayBasedList<ElementType, Capacity>::const_iterator::skipEmptyShards()
+{
+    // Move to the first element of the next non-empty shard, or to end()
+    while (node == list->shards[shard].end())
+    {
+        if (++shard == (int)list->shards.size())
+        {
+            shard = NULL_INDEX;
+            node = typename Shard::const_iterator();
+            return;
+        }
+        node = list->shards[shard].begin();
+    }
+}
+
+// Definition of const_iterator operator*()
+template <typename ElementType, int Capacity>
+typename ShardedArrayBasedList<ElementType, Capacity>::const_iterator::reference
+ShardedArrayBasedList<ElementType, Capacity>::const_iterator::operator*() const
+{
+    return *node;
+}
+
+// Definition of const_iterator operator->()
+template <typename ElementType, int Capacity>
+typename ShardedArrayBasedList<ElementType, Capacity>::const_iterator::pointer
+ShardedArrayBasedList<ElementType, Capacity>::const_iterator::operator->() const
+{
+    return &*node;
+}
+
+// Definition of const_iterator prefix operator++()
+template <typename ElementType, int Capacity>
+typename ShardedArrayBasedList<ElementType, Capacity>::const_iterator &
+ShardedArrayBasedList<ElementType, Capacity>::const_iterator::operator++()
+{
+    ++node;
+    skipEmptyShards();
+    return *this;
+}
+
+// Definition of const_iterator postfix operator++()
+template <typename ElementType, int Capacity>
+typename ShardedArrayBasedList<ElementType, Capacity>::const_iterator
+ShardedArrayBasedList<ElementType, Capacity>::const_iterator::operator++(int)
+{
+    const_iterator old = *this;
+    ++*this;
+    return old;
+}
+
+// Definition of const_iterator operator==()
+template <typename ElementType, int Capacity>
+bool ShardedArrayBasedList<ElementType, Capacity>::const_iterator::operator==(
+    const const_iterator &other) const
+{
+    return shard == other.shard && (shard == NULL_INDEX || node == other.node);
+}
+
+// Definition of const_iterator operator!=()
+template <typename ElementType, int Capacity>
+bool ShardedArrayBasedList<ElementType, Capacity>::const_iterator::operator!=(
+    const const_iterator &other) const
+{
+    return !(*this == other);
+}
+
+// Definition of constructor
+template <typename ElementType, int Capacity>
+ShardedArrayBasedList<ElementType, Capacity>::ShardedArrayBasedList(int shardCount)
+    : shards(shardCount), sizes(shardCount, 0) {}
+
+// Definition of assign()
+template <typename ElementType, int Capacity>
+template <typename ForwardIterator>
+int ShardedArrayBasedList<ElementType, Capacity>::assign(ForwardIterator rangeBegin,
+                                                         ForwardIterator rangeEnd)
+{
+    distribute(vector<ElementType>(rangeBegin, rangeEnd));
+    return size();
+}
+
+// Definition of isEmpty()
+template <typename ElementType, int Capacity>
+bool ShardedArrayBasedList<ElementType, Capacity>::isEmpty() const
+{
+    return size() == 0;
+}
+
+// Definition of insertAtPosition()
+template <typename ElementType, int Capacity>
+bool ShardedArrayBasedList<ElementType, Capacity>::insertAtPosition(const ElementType &value,
+                                                                    int position)
+{
+    if (position < 0) // Invalid index
+        return false;
+
+    int shard = locate(position, true);
+    if (shard == NULL_INDEX) // position past the end
+        return false;
+
+    if (!shards[shard].insertAtPosition(value, position))
+        return false;
+    sizes[shard]++;
+    return true;
+}
+
+// Definition of deleteAtPosition()
+template <typename ElementType, int Capacity>
+bool ShardedArrayBasedList<ElementType, Capacity>::deleteAtPosition(int position)
+{
+    if (position < 0) // Invalid index
+        return false;
+
+    int shard = locate(position, false);
+    if (shard == NULL_INDEX || !shards[shard].deleteAtPosition(position))
+        return false;
+    sizes[shard]--;
+    return true;
+}
+
+// Definition of append()
+template <typename ElementType, int Capacity>
+bool ShardedArrayBasedList<ElementType, Capacity>::append(const ElementType &value)
+{
+    int last = (int)shards.size() - 1;
+    if (!shards[last].insertAtPosition(value, sizes[last]))
+        return false;
+    sizes[last]++;
+    return true;
+}
+
+// Definition of search()
+template <typename ElementType, int Capacity>
+int ShardedArrayBasedList<ElementType, Capacity>::search(const ElementType &data) const
+{
+    vector<int> found(shards.size());
+    forEachShard([&](int shard) { found[shard] = shards[shard].search(data); });
+
+    // First shard with a match holds the first occurrence
+    int offset = 0; // position of the first element of the shard
+    for (size_t shard = 0; shard < shards.size(); shard++)
+    {
+        if (found[shard] != NULL_INDEX)
+            return offset + found[shard];
+        offset += sizes[shard];
+    }
+    return NULL_INDEX;
+}
+
+// Definition of count()
+template <typename ElementType, int Capacity>
+int ShardedArrayBasedList<ElementType, Capacity>::count(const ElementType &data) const
+{
+    vector<int> counts(shards.size(), 0);
+    forEachShard([&](int shard) {
+        int matches = 0;
+        for (const ElementType &element : shards[shard])
+            if (element == data)
+                matches++;
+        counts[shard] = matches;
+    });
+
+    int total = 0;
+    for (size_t shard = 0; shard < shards.size(); shard++)
+        total += counts[shard];
+    return total;
+}
+
+// Definition of removeIf()
+template <typename ElementType, int Capacity>
+template <typename Predicate>
+int ShardedArrayBasedList<ElementType, Capacity>::removeIf(Predicate predicate)
+{
+    vector<int> removed(shards.size(), 0);
+    forEachShard([&](int shard) {
+        removed[shard] = shards[shard].removeIf(predicate);
+        sizes[shard] -= removed[shard];
+    });
+
+    int total = 0;
+    for (size_t shard = 0; shard < shards.size(); shard++)
+        total += removed[shard];
+    return total;
+}
+
+// Definition of sort()
+template <typename ElementType, int Capacity>
+void ShardedArrayBasedList<ElementType, Capacity>::sort()
+{
+    // Sort a copy of every shard in parallel
+    vector<vector<ElementType>> runs(shards.size());
+    forEachShard([&](int shard) {
+        runs[shard].assign(shards[shard].begin(), shards[shard].end());
+        std::sort(runs[shard].begin(), runs[shard].end(),
+                  [](const ElementType &a, const ElementType &b) { return b > a; });
+    });
+
+    // Merge the runs, smallest head first (ties: lower shard first)
+    typedef pair<int, size_t> Head; // (run, index in the run)
+    auto later = [&](const Head &a, const Head &b) {
+        const ElementType &x = runs[a.first][a.second];
+        const ElementType &y = runs[b.first][b.second];
+        return x > y || (!(y > x) && a.first > b.first);
+    };
+    priority_queue<Head, vector<Head>, decltype(later)> heads(later);
+    for (size_t run = 0; run < runs.size(); run++)
+        if (!runs[run].empty())
+            heads.push(Head((int)run, 0));
+
+    vector<ElementType> sorted;
+    sorted.reserve(size());
+    while (!heads.empty())
+    {
+        Head head = heads.top();
+        heads.pop();
+        sorted.push_back(runs[head.first][head.second]);
+        if (++head.second < runs[head.first].size())
+            heads.push(head);
+    }
+    runs.clear();
+
+    distribute(sorted);
+}
+
+// Definition of rebalance()
+template <typename ElementType, int Capacity>
+void ShardedArrayBasedList<ElementType, Capacity>::rebalance()
+{
+    distribute(vector<ElementType>(begin(), end()));
+}
+
+// Definition of size()
+template <typename ElementType, int Capacity>
+int ShardedArrayBasedList<ElementType, Capacity>::size() const
+{
+    int total = 0;
+    for (size_t shard = 0; shard < sizes.size(); shard++)
+        total += sizes[shard];
+    return total;
+}
+
+// Definition of shardCount()
+template <typename ElementType, int Capacity>
+int ShardedArrayBasedList<ElementType, Capacity>::shardCount() const
+{
+    return (int)shards.size();
+}
+
+// Definition of shardSize()
+template <typename ElementType, int Capacity>
+int ShardedArrayBasedList<ElementType, Capacity>::shardSize(int shard) const
+{
+    return sizes[shard];
+}
+
+// Definition of display()
+template <typename ElementType, int Capacity>
+void ShardedArrayBasedList<ElementType, Capacity>::display(ostream &out) const
+{
+    if (isEmpty()) // list is empty
+    {
+        out << "List is empty";
+    }
+    else
+    {
+        for (const_iterator i = begin(); i != end(); ++i)
+        {
+            if (i != begin()) // separate from the previous element
+                out << ", ";
+            out << *i;
+        }
+    }
+    out << '\n';
+}
+
+// Definition of clear()
+template <typename ElementType, int Capacity>
+void ShardedArrayBasedList<ElementType, Capacity>::clear()
+{
+    for (size_t shard = 0; shard < shards.size(); shard++)
+    {
+        shards[shard].clear();
+        sizes[shard] = 0;
+    }
+}
+
+// Definition of begin()
+template <typename ElementType, int Capacity>
+typename ShardedArrayBasedList<ElementType, Capacity>::const_iterator
+ShardedArrayBasedList<ElementType, Capacity>::begin() const
+{
+    return const_iterator(this, 0);
+}
+
+// Definition of end()
+template <typename ElementType, int Capacity>
+typename ShardedArrayBasedList<ElementType, Capacity>::const_iterator
+ShardedArrayBasedList<ElementType, Capacity>::end() const
+{
+    return const_iterator(this, NULL_INDEX);
+}
+
+// Definition of forEachShard()
+template <typename ElementType, int Capacity>
+void ShardedArrayBasedList<ElementType, Capacity>::forEachShard(
+    const function<void(int)> &task) const
+{
+    vector<thread> workers;
+    for (size_t shard = 1; shard < shards.size(); shard++)
+        workers.emplace_back(task, (int)shard);
+    task(0);
+    for (size_t i = 0; i < workers.size(); i++)
+        workers[i].join();
+}
+
+// Definition of locate()
+template <typename ElementType, int Capacity>
+int ShardedArrayBasedList<ElementType, Capacity>::locate(int &position, bool inserting) const
+{
+    for (size_t shard = 0; shard < shards.size(); shard++)
+    {
+        if (position < sizes[shard])
+            return (int)shard;
+        if (inserting && position == sizes[shard])
+        {
+            // At the end of this shard, or at the start of the next one:
+            // take the smaller
+            if (shard + 1 < shards.size() && sizes[shard + 1] < sizes[shard])
+            {
+                position = 0;
+                return (int)shard + 1;
+            }
+            return (int)shard;
+        }
+        position -= sizes[shard];
+    }
+    return NULL_INDEX;
+}
+
+// Definition of distribute()
+template <typename ElementType, int Capacity>
+void ShardedArrayBasedList<ElementType, Capacity>::distribute(const vector<ElementType> &elements)
+{
+    size_t total = elements.size();
+    size_t count = shards.size();
+    forEachShard([&](int shard) {
+        size_t from = total * shard / count; // slice of this shard
+        size_t to = total * (shard + 1) / count;
+        shards[shard].clear();
+        sizes[shard] = shards[shard].appendRange(elements.begin() + from,
+                                                 elements.begin() + to);
+    });
+}
+
+#endif
@@ -0,0 +1,441 @@
+/*-- SharedList.h --------------------------------------------------------------
+    This header file defines the template class SharedList, which keeps an
+    ArrayBasedList in a POSIX shared-memory segment so that several processes
+    can use the same list without copying it.
+
+    Nodes refer to each other by index, so the list works no matter at which
+    address each process maps the segment. Access is synchronized with a
+    process-shared mutex stored in the segment, and a process-shared condition
+    variable lets a consumer sleep until a producer changes the list.
+
+    Segment layout:
+        offset 0:                 ListImageHeader (see PersistentList.h)
+        offset LIST_IMAGE_OFFSET: SharedListControl (mutex and condition)
+        offset listOffset():      ArrayBasedList<ElementType, Capacity> image
+
+    Basic operations are:
+        Constructor: Constructs a SharedList not attached to any segment.
+        Destructor: Detaches from the segment.
+        create: Create and attach a new segment holding an empty list.
+        attach: Attach to a segment created by another process.
+        detach: Unmap the segment.
+        remove: Remove a segment name from the system.
+        isAttached: Check if a segment is mapped.
+        lock: Acquire the shared mutex, reporting a dead previous owner.
+        unlock: Release the shared mutex.
+        wait: Sleep until another process calls notify.
+        notify: Wake every process waiting on the list.
+        list: Access the shared ArrayBasedList.
+
+    Usage:
+        Every access to list() must happen between a successful lock() and
+        unlock().
+------------------------------------------------------------------------------*/
+
+#ifndef SHAREDLIST_H
+#define SHAREDLIST_H
+
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "ArrayBasedList.h"
+#include "PersistentList.h"
+
+using namespace std;
+
+/** Synchronization objects stored in a shared list segment */
+struct SharedListControl
+{
+    pthread_mutex_t mutex;  // protects the list
+    pthread_cond_t changed; // signalled when the list changes
+};
+
+template <typename ElementType, int Capacity = CAPACITY>
+class SharedList
+{
+    static_assert(is_trivially_copyable<ElementType>::value,
+                  "SharedList requires a trivially copyable ElementType");
+    static_assert(Capacity != GROWABLE,
+                  "SharedList requires a fixed Capacity (no heap chunks)");
+
+public:
+    typedef ArrayBasedList<ElementType, Capacity> ListType;
+
+    /******** Member Functions ********/
+
+    /***** Class constructor *****/
+    SharedList();
+    /*--------------------------------------------------------------------------
+        Construct a SharedList not attached to any segment.
+
+        Precondition:  None.
+        Postcondition: isAttached() returns false.
+    --------------------------------------------------------------------------*/
+
+    /***** Class destructor *****/
+    ~SharedList();
+    /*--------------------------------------------------------------------------
+        Detach from the segment.
+
+        Precondition:  The calling process does not hold the lock.
+        Postcondition: The segment is unmapped; it stays available to other
+                       processes until remove() is called.
+    --------------------------------------------------------------------------*/
+
+    SharedList(const SharedList &) = delete;
+    SharedList &operator=(const SharedList &) = delete;
+
+    bool create(const char *name);
+    /*--------------------------------------------------------------------------
+        Create a new segment holding an empty list and attach to it.
+
+        Precondition:  name is a valid shm_open name ("/something"); no
+                       segment with that name exists.
+        Postcondition: The segment is created and initialized. Returns true on
+                       success, false otherwise.
+    --------------------------------------------------------------------------*/
+
+    bool attach(const char *name);
+    /*--------------------------------------------------------------------------
+        Attach to a segment created by another process.
+
+        Precondition:  None.
+        Postcondition: Returns true if the segment exists, is fully initialized
+                       and holds a list of this type; false otherwise (the
+                       caller may retry if the creator is still starting).
+    --------------------------------------------------------------------------*/
+
+    void detach();
+    /*--------------------------------------------------------------------------
+        Unmap the segment.
+
+        Precondition:  The calling process does not hold the lock.
+        Postcondition: isAttached() returns false.
+    --------------------------------------------------------------------------*/
+
+    static bool remove(const char *name);
+    /*--------------------------------------------------------------------------
+        Remove a segment name from the system.
+
+        Precondition:  None.
+        Postcondition: The name is unlinked; processes still attached keep
+                       their mapping. Returns true on success.
+    --------------------------------------------------------------------------*/
+
+    bool isAttached() const;
+    /*--------------------------------------------------------------------------
+        Check if a segment is mapped.
+
+        Precondition:  None.
+        Postcondition: Returns true if attached, false otherwise.
+    --------------------------------------------------------------------------*/
+
+    bool lock(bool *ownerDied = nullptr);
+    /*--------------------------------------------------------------------------
+        Acquire the shared mutex.
+
+        Precondition:  Attached; the calling thread does not hold the lock.
+        Postcondition: Returns true if the calling thread holds the lock, and
+                       false, without the lock, if it could not be acquired
+                       (for example, the mutex is no longer recoverable). If
+                       the previous owner died while holding it, the lock is
+                       recovered and *ownerDied (when given) is set to true:
+                       that owner's last operation may have been cut short
+                       anywhere (a sort() half way through a swap, a node on
+                       neither chain), so the caller must check or rebuild
+                       the list (for example with clear()) before trusting
+                       it. Otherwise *ownerDied is set to false.
+    --------------------------------------------------------------------------*/
+
+    void unlock();
+    /*--------------------------------------------------------------------------
+        Release the shared mutex.
+
+        Precondition:  The calling thread holds the lock.
+        Postcondition: The lock is released.
+    --------------------------------------------------------------------------*/
+
+    bool wait(bool *ownerDied = nullptr);
+    /*--------------------------------------------------------------------------
+        Sleep until another process calls notify().
+
+        Precondition:  The calling thread holds the lock.
+        Postcondition: Same as lock(): returns true if the calling thread
+                       holds the lock again (with *ownerDied telling if it
+                       was recovered from a dead owner), false if it does
+                       not. Wakeups may be spurious, so the caller must
+                       recheck its condition.
+    --------------------------------------------------------------------------*/
+
+    void notify();
+    /*--------------------------------------------------------------------------
+        Wake every process waiting on the list.
+
+        Precondition:  Attached.
+        Postcondition: Every thread blocked in wait() is woken.
+    --------------------------------------------------------------------------*/
+
+    ListType &list();
+    /*--------------------------------------------------------------------------
+        Access the shared list.
+
+        Precondition:  Attached; the calling thread holds the lock.
+        Postcondition: Returns the list stored in the segment.
+    --------------------------------------------------------------------------*/
+
+    static size_t listOffset();
+    /*--------------------------------------------------------------------------
+        Offset of the list image in the segment.
+
+        Precondition:  None.
+        Postcondition: Returns an offset after the control block, rounded up
+                       to LIST_IMAGE_OFFSET.
+    --------------------------------------------------------------------------*/
+
+    static size_t segmentSize();
+    /*--------------------------------------------------------------------------
+        Size in bytes of a segment for this list type.
+
+        Precondition:  None.
+        Postcondition: Returns listOffset() plus the size of the list.
+    --------------------------------------------------------------------------*/
+
+private:
+    bool map(int fd);
+    /*--------------------------------------------------------------------------
+        Map the segment open on fd.
+
+        Precondition:  fd refers to a segment of segmentSize() bytes.
+        Postcondition: Returns true if the segment is mapped; fd is closed in
+                       every case.
+    --------------------------------------------------------------------------*/
+
+    bool lockResult(int result, bool *ownerDied);
+    /*--------------------------------------------------------------------------
+        Interpret the result of locking the shared mutex.
+
+        Precondition:  result was returned by pthread_mutex_lock() or
+                       pthread_cond_wait() on the shared mutex.
+        Postcondition: Same as the postcondition of lock().
+    --------------------------------------------------------------------------*/
+
+    void *mapping;              // start of the mapped segment, or nullptr
+    SharedListControl *control; // synchronization objects in the segment
+    ListType *image;            // list stored in the segment
+
+}; // end of class declaration
+
+/**************** FUNCTION DEFINITIONS ****************************************/
+
+// Definition of constructor
+template <typename ElementType, int Capacity>
+SharedList<ElementType, Capacity>::SharedList()
+    : mapping(nullptr), control(nullptr), image(nullptr) {}
+
+// Definition of destructor
+template <typename ElementType, int Capacity>
+SharedList<ElementType, Capacity>::~SharedList()
+{
+    detach();
+}
+
+// Definition of create()
+template <typename ElementType, int Capacity>
+bool SharedList<ElementType, Capacity>::create(const char *name)
+{
+    if (isAttached())
+        return false;
+
+    int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd < 0)
+        return false;
+
+    if (ftruncate(fd, segmentSize()) != 0 || !map(fd))
+    {
+        shm_unlink(name);
+        return false;
+    }
+
+    // Initialize the process-shared, robust mutex and condition variable
+    pthread_mutexattr_t mutexAttributes;
+    pthread_mutexattr_init(&mutexAttributes);
+    pthread_mutexattr_setpshared(&mutexAttributes, PTHREAD_PROCESS_SHARED);
+    pthread_mutexattr_setrobust(&mutexAttributes, PTHREAD_MUTEX_ROBUST);
+    pthread_mutex_init(&control->mutex, &mutexAttributes);
+    pthread_mutexattr_destroy(&mutexAttributes);
+
+    pthread_condattr_t condAttributes;
+    pthread_condattr_init(&condAttributes);
+    pthread_condattr_setpshared(&condAttributes, PTHREAD_PROCESS_SHARED);
+    pthread_cond_init(&control->changed, &condAttributes);
+    pthread_condattr_destroy(&condAttributes);
+
+    new (image) ListType(); // empty list
+
+    // Stamp the header last: attach() only accepts fully built segments
+    ListImageHeader header;
+    initListImageHeader<ElementType, Capacity>(header);
+    ListImageHeader *stored = static_cast<ListImageHeader *>(mapping);
+    memcpy(stored, &header, sizeof(header) - sizeof(header.imageSize));
+    __atomic_store_n(&stored->imageSize, header.imageSize, __ATOMIC_RELEASE);
+    return true;
+}
+
+// Definition of attach()
+template <typename ElementType, int Capacity>
+bool SharedList<ElementType, Capacity>::attach(const char *name)
+{
+    if (isAttached())
+        return false;
+
+    int fd = shm_open(name, O_RDWR, 0600);
+    if (fd < 0)
+        return false;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size != segmentSize())
+    {
+        ::close(fd);
+        return false;
+    }
+    if (!map(fd))
+        return false;
+
+    // imageSize is written last by create(), so read it first
+    ListImageHeader *stored = static_cast<ListImageHeader *>(mapping);
+    ListImageHeader header;
+    header.imageSize = __atomic_load_n(&stored->imageSize, __ATOMIC_ACQUIRE);
+    memcpy(&header, stored, sizeof(header) - sizeof(header.imageSize));
+
+    if (!validListImageHeader<ElementType, Capacity>(header))
+    {
+        detach();
+        return false;
+    }
+    image = std::launder(image); // the list was built by another process
+    return true;
+}
+
+// Definition of detach()
+template <typename ElementType, int Capacity>
+void SharedList<ElementType, Capacity>::detach()
+{
+    if (mapping != nullptr)
+        munmap(mapping, segmentSize());
+
+    mapping = nullptr;
+    control = nullptr;
+    image = nullptr;
+}
+
+// Definition of remove()
+template <typename ElementType, int Capacity>
+bool SharedList<ElementType, Capacity>::remove(const char *name)
+{
+    return shm_unlink(name) == 0;
+}
+
+// Definition of isAttached()
+template <typename ElementType, int Capacity>
+bool SharedList<ElementType, Capacity>::isAttached() const
+{
+    return mapping != nullptr;
+}
+
+// Definition of lock()
+template <typename ElementType, int Capacity>
+bool SharedList<ElementType, Capacity>::lock(bool *ownerDied)
+{
+    return lockResult(pthread_mutex_lock(&control->mutex), ownerDied);
+}
+
+// Definition of unlock()
+template <typename ElementType, int Capacity>
+void SharedList<ElementType, Capacity>::unlock()
+{
+    pthread_mutex_unlock(&control->mutex);
+}
+
+// Definition of wait()
+template <typename ElementType, int Capacity>
+bool SharedList<ElementType, Capacity>::wait(bool *ownerDied)
+{
+    return lockResult(pthread_cond_wait(&control->changed, &control->mutex),
+                      ownerDied);
+}
+
+// Definition of lockResult()
+template <typename ElementType, int Capacity>
+bool SharedList<ElementType, Capacity>::lockResult(int result, bool *ownerDied)
+{
+    if (ownerDied != nullptr)
+        *ownerDied = result == EOWNERDEAD;
+
+    if (result == EOWNERDEAD)
+    {
+        // The owner died holding the lock: keep the mutex usable, and let
+        // the caller decide whether the list can still be trusted
+        if (pthread_mutex_consistent(&control->mutex) != 0)
+        {
+            pthread_mutex_unlock(&control->mutex);
+            return false;
+        }
+        return true;
+    }
+    return result == 0; // any other error: the lock is not held
+}
+
+// Definition of notify()
+template <typename ElementType, int Capacity>
+void SharedList<ElementType, Capacity>::notify()
+{
+    pthread_cond_broadcast(&control->changed);
+}
+
+// Definition of list()
+template <typename ElementType, int Capacity>
+typename SharedList<ElementType, Capacity>::ListType &
+SharedList<ElementType, Capacity>::list()
+{
+    return *image;
+}
+
+// Definition of listOffset()
+template <typename ElementType, int Capacity>
+size_t SharedList<ElementType, Capacity>::listOffset()
+{
+    size_t end = LIST_IMAGE_OFFSET + sizeof(SharedListControl);
+    return (end + LIST_IMAGE_OFFSET - 1) / LIST_IMAGE_OFFSET * LIST_IMAGE_OFFSET;
+}
+
+// Definition of segmentSize()
+template <typename ElementType, int Capacity>
+size_t SharedList<ElementType, Capacity>::segmentSize()
+{
+    return listOffset() + sizeof(ListType);
+}
+
+// Definition of map()
+template <typename ElementType, int Capacity>
+bool SharedList<ElementType, Capacity>::map(int fd)
+{
+    void *address = mmap(nullptr, segmentSize(), PROT_READ | PROT_WRITE,
+                         MAP_SHARED, fd, 0);
+    ::close(fd); // the mapping keeps the segment alive
+    if (address == MAP_FAILED)
+        return false;
+
+    mapping = address;
+    control = reinterpret_cast<SharedListControl *>(
+        static_cast<char *>(mapping) + LIST_IMAGE_OFFSET);
+    image = reinterpret_cast<ListType *>(static_cast<char *>(mapping) + listOffset());
+    return true;
+}
+
+#endif
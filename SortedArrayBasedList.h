@@ -0,0 +1,607 @@
+/*-- SortedArrayBasedList.h ----------------------------------------------------
+    This header file defines the template class SortedArrayBasedList, a list
+    built on a NodePool that keeps its elements in ascending order.
+
+    Every insert places the new element after the elements that do not
+    compare greater than it, so the list never needs sort(). Keeping the
+    order lets search and deleteValue stop at the first greater element, and
+    lets unique and the set operations work in one linear pass: set
+    operations merge two lists and append their output directly to the
+    result list, in order, without sorting it again.
+
+    The list remembers its last node, so an insert of an element not less
+    than the last one (such as a batch of inserts already in order) is O(1).
+
+    Basic operations are:
+        Constructor: Constructs an empty list.
+        isEmpty: Check if list is empty.
+        insert: Insert an element at its place in the order.
+        deleteValue: Delete the first occurrence of a value.
+        search: Search for a value.
+        size: Returns the size of the list.
+        unique: Remove all but the first of every run of equal elements.
+        setUnion, setIntersection, setDifference: Combine two lists into a
+                  third one.
+        display: Print list content.
+        clear: Remove every element from the list.
+
+    const_iterator (nested class) walks the list in order, read-only.
+
+    Compare is a strict weak ordering on ElementType (default less<>); two
+    elements are equal when neither is less than the other. The set
+    operations treat the lists as multisets, with the semantics of
+    std::set_union, std::set_intersection and std::set_difference.
+
+    Class Invariant:
+        1. first / last store the ends of the list, or NULL_INDEX if the list
+           is empty; count is the number of elements.
+        2. No element is less than (by Compare) the element before it.
+------------------------------------------------------------------------------*/
+
+#ifndef SORTEDARRAYBASEDLIST_H
+#define SORTEDARRAYBASEDLIST_H
+
+#include <cstddef>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include "NodePool.h"
+
+using namespace std;
+
+template <typename ElementType, typename Compare = less<ElementType>,
+          int Capacity = CAPACITY>
+class SortedArrayBasedList
+{
+public:
+    /** Public class const_iterator */
+    class const_iterator
+    {
+    public:
+        typedef forward_iterator_tag iterator_category;
+        typedef ElementType value_type;
+        typedef ptrdiff_t difference_type;
+        typedef const ElementType *pointer;
+        typedef const ElementType &reference;
+
+        /******** Member Functions ********/
+
+        /***** Class constructor *****/
+        const_iterator();
+        /*----------------------------------------------------------------------
+            Construct an iterator equal to end() of any list.
+
+            Precondition:  None.
+            Postcondition: The iterator refers to no element.
+        ----------------------------------------------------------------------*/
+
+        reference operator*() const;
+        pointer operator->() const;
+        /*----------------------------------------------------------------------
+            Access the element the iterator refers to.
+
+            Precondition:  The iterator is not end().
+            Postcondition: Returns the current element.
+        ----------------------------------------------------------------------*/
+
+        const_iterator &operator++();
+        const_iterator operator++(int);
+        /*----------------------------------------------------------------------
+            Move to the next element.
+
+            Precondition:  The iterator is not end().
+            Postcondition: The iterator refers to the next element, or is
+                           end() if it was at the last one.
+        ----------------------------------------------------------------------*/
+
+        bool operator==(const const_iterator &other) const;
+        bool operator!=(const const_iterator &other) const;
+        /*----------------------------------------------------------------------
+            Compare two iterators.
+
+            Precondition:  Both iterators belong to the same list.
+            Postcondition: Returns whether they refer to the same element.
+        ----------------------------------------------------------------------*/
+
+    private:
+        friend class SortedArrayBasedList;
+        const_iterator(const NodePool<ElementType, Capacity> *pool, int index);
+
+        /******** Data members ********/
+        const NodePool<ElementType, Capacity> *pool; // pool of the list
+        int index;                                   // current node
+    };
+
+    /******** Member Functions ********/
+
+    /***** Class constructor *****/
+    SortedArrayBasedList();
+    /*--------------------------------------------------------------------------
+        Construct an empty SortedArrayBasedList.
+
+        Precondition:  None.
+        Postcondition: An empty list is constructed; first and last are
+                       NULL_INDEX.
+    --------------------------------------------------------------------------*/
+
+    bool isEmpty() const;
+    /*--------------------------------------------------------------------------
+        Check if the list is empty.
+
+        Precondition:  None
+        Postcondition: Returns true if the list has no elements.
+------------------------------------------------------------------------------*/
+
+    bool insert(const ElementType &value);
+    /*--------------------------------------------------------------------------
+        Insert an element at its place in the order.
+
+        Precondition:  None.
+        Postcondition: 'value' is linked after every element not greater than
+                       it (after equal elements) and true is returned; false
+                       if the NodePool is full. O(1) if 'value' is not less
+                       than the last element, one walk otherwise.
+------------------------------------------------------------------------------*/
+
+    bool deleteValue(const ElementType &value);
+    /*--------------------------------------------------------------------------
+        Remove the first occurrence of a value from the list.
+
+        Precondition:  None.
+        Postcondition: Returns true if the value was found and removed. The
+                       walk stops at the first element greater than 'value'.
+------------------------------------------------------------------------------*/
+
+    int search(const ElementType &data) const;
+    /*--------------------------------------------------------------------------
+        Search for the first occurrence of a value in the list.
+
+        Precondition:  None
+        Postcondition: Returns the position of the first element equal to
+                       'data', or NULL_INDEX if it is not found. The walk
+                       stops at the first element not less than 'data'.
+------------------------------------------------------------------------------*/
+
+    int size() const;
+    /*--------------------------------------------------------------------------
+        Returns the size of the list.
+
+        Precondition:  None.
+        Postcondition: List size is returned, in O(1).
+------------------------------------------------------------------------------*/
+
+    int unique();
+    /*--------------------------------------------------------------------------
+        Remove duplicates.
+
+        Precondition:  None.
+        Postcondition: Only the first element of every run of equal elements
+                       is kept; returns the number of elements removed, in
+                       one pass.
+------------------------------------------------------------------------------*/
+
+    bool setUnion(const SortedArrayBasedList &other,
+                  SortedArrayBasedList &result) const;
+    bool setIntersection(const SortedArrayBasedList &other,
+                         SortedArrayBasedList &result) const;
+    bool setDifference(const SortedArrayBasedList &other,
+                       SortedArrayBasedList &result) const;
+    /*--------------------------------------------------------------------------
+        Combine this list with 'other' into 'result': elements in either
+        list / in both lists / in this list but not in 'other'.
+
+        Precondition:  'result' is neither this list nor 'other'.
+        Postcondition: 'result' is cleared, then receives the combination, in
+                       order, in one merge pass over both lists. Returns
+                       true, or false if result's NodePool filled up (result
+                       then holds the smallest elements of the combination).
+------------------------------------------------------------------------------*/
+
+    void display(ostream &out) const;
+    /*--------------------------------------------------------------------------
+        Display all elements in the list in order.
+
+        Precondition:  None
+        Postcondition: Outputs all elements, separated by ", ", to 'out', or
+                       "List is empty", followed by '\n'.
+------------------------------------------------------------------------------*/
+
+    void clear();
+    /*--------------------------------------------------------------------------
+        Remove every element from the list.
+
+        Precondition:  None.
+        Postcondition: The list is empty and the NodePool is reset.
+------------------------------------------------------------------------------*/
+
+    const_iterator begin() const;
+    const_iterator end() const;
+    /*--------------------------------------------------------------------------
+        Get an iterator to the first element / the past-the-end iterator.
+
+        Precondition:  None.
+        Postcondition: Returns the iterator.
+------------------------------------------------------------------------------*/
+
+private:
+    bool append(const ElementType &value);
+    /*--------------------------------------------------------------------------
+        Link 'value' after the last node, in O(1).
+
+        Precondition:  No element is greater than 'value'.
+        Postcondition: Returns true, or false if the NodePool is full.
+------------------------------------------------------------------------------*/
+
+    bool equal(const ElementType &a, const ElementType &b) const;
+    /*--------------------------------------------------------------------------
+        Returns true if neither element is less than the other.
+------------------------------------------------------------------------------*/
+
+    NodePool<ElementType, Capacity> nodePool; // elements and links
+    Compare compare;                          // order of the elements
+    int first;                                // first node in the list
+    int last;                                 // last node in the list
+    int count;                                // number of elements
+
+}; // end of class declaration
+
+/**************** FUNCTION DEFINITIONS ****************************************/
+
+// Definition of const_iterator no-arg constructor
+template <typename ElementType, typename Compare, int Capacity>
+SortedArrayBasedList<ElementType, Compare, Capacity>::const_iterator::const_iterator()
+    : pool(nullptr), index(NULL_INDEX) {}
+
+// Definition of const_iterator constructor with pool and index
+template <typename ElementType, typename Compare, int Capacity>
+SortedArrayBasedList<ElementType, Compare, Capacity>::const_iterator::const_iterator(
+    const NodePool<ElementType, Capacity> *pool, int index)
+    : pool(pool), index(index) {}
+
+// Definition of const_iterator operator*()
+template <typename ElementType, typename Compare, int Capacity>
+typename SortedArrayBasedList<ElementType, Compare, Capacity>::const_iterator::reference
+SortedArrayBasedList<ElementType, Compare, Capacity>::const_iterator::operator*() const
+{
+    return pool->nodeData(index);
+}
+
+// Definition of const_iterator operator->()
+template <typename ElementType, typename Compare, int Capacity>
+typename SortedArrayBasedList<ElementType, Compare, Capacity>::const_iterator::pointer
+SortedArrayBasedList<ElementType, Compare, Capacity>::const_iterator::operator->() const
+{
+    return &pool->nodeData(index);
+}
+
+// Definition of const_iterator prefix operator++()
+template <typename ElementType, typename Compare, int Capacity>
+typename SortedArrayBasedList<ElementType, Compare, Capacity>::const_iterator &
+SortedArrayBasedList<ElementType, Compare, Capacity>::const_iterator::operator++()
+{
+    index = pool->getNextOfNode(index);
+    return *this;
+}
+
+// Definition of const_iterator postfix operator++()
+template <typename ElementType, typename Compare, int Capacity>
+typename SortedArrayBasedList<ElementType, Compare, Capacity>::const_iterator
+SortedArrayBasedList<ElementType, Compare, Capacity>::const_iterator::operator++(int)
+{
+    const_iterator old = *this;
+    index = pool->getNextOfNode(index);
+    return old;
+}
+
+// Definition of const_iterator operator==()
+template <typename ElementType, typename Compare, int Capacity>
+bool SortedArrayBasedList<ElementType, Compare, Capacity>::const_iterator::operator==(
+    const const_iterator &other) const
+{
+    return index == other.index;
+}
+
+// Definition of const_iterator operator!=()
+template <typename ElementType, typename Compare, int Capacity>
+bool SortedArrayBasedList<ElementType, Compare, Capacity>::const_iterator::operator!=(
+    const const_iterator &other) const
+{
+    return index != other.index;
+}
+
+// Definition of constructor
+template <typename ElementType, typename Compare, int Capacity>
+SortedArrayBasedList<ElementType, Compare, Capacity>::SortedArrayBasedList()
+    : first(NULL_INDEX), last(NULL_INDEX), count(0) {}
+
+// Definition of isEmpty()
+template <typename ElementType, typename Compare, int Capacity>
+bool SortedArrayBasedList<ElementType, Compare, Capacity>::isEmpty() const
+{
+    return first == NULL_INDEX;
+}
+
+// Definition of insert()
+template <typename ElementType, typename Compare, int Capacity>
+bool SortedArrayBasedList<ElementType, Compare, Capacity>::insert(const ElementType &value)
+{
+    // Not less than the last element (or list is empty): append in O(1)
+    if (last == NULL_INDEX || !compare(value, nodePool.nodeData(last)))
+        return append(value);
+
+    int newNode = nodePool.acquireNode(); // get free node
+    if (newNode == NULL_INDEX)            // list is full
+        return false;
+    nodePool.setNodeData(newNode, value);
+
+    if (compare(value, nodePool.nodeData(first))) // new first element
+    {
+        nodePool.setNextOfNode(newNode, first);
+        first = newNode;
+    }
+    else
+    {
+        // Find the last node not greater than value; the walk stops before
+        // 'last', which is greater than value
+        int prev = first;
+        while (!compare(value, nodePool.nodeData(nodePool.getNextOfNode(prev))))
+            prev = nodePool.getNextOfNode(prev);
+
+        nodePool.setNextOfNode(newNode, nodePool.getNextOfNode(prev));
+        nodePool.setNextOfNode(prev, newNode);
+    }
+    count++;
+    return true;
+}
+
+// Definition of deleteValue()
+template <typename ElementType, typename Compare, int Capacity>
+bool SortedArrayBasedList<ElementType, Compare, Capacity>::deleteValue(const ElementType &value)
+{
+    int prev = NULL_INDEX;
+    int curr = first;
+
+    // Skip the elements less than value
+    while (curr != NULL_INDEX && compare(nodePool.nodeData(curr), value))
+    {
+        prev = curr;
+        curr = nodePool.getNextOfNode(curr);
+    }
+    if (curr == NULL_INDEX || compare(value, nodePool.nodeData(curr))) // not found
+        return false;
+
+    int next = nodePool.getNextOfNode(curr);
+    if (prev == NULL_INDEX)
+        first = next;
+    else
+        nodePool.setNextOfNode(prev, next);
+    if (curr == last)
+        last = prev;
+    nodePool.releaseNode(curr);
+    count--;
+    return true;
+}
+
+// Definition of search()
+template <typename ElementType, typename Compare, int Capacity>
+int SortedArrayBasedList<ElementType, Compare, Capacity>::search(const ElementType &data) const
+{
+    int position = 0;
+
+    // Skip the elements less than data
+    int i = first;
+    while (i != NULL_INDEX && compare(nodePool.nodeData(i), data))
+    {
+        i = nodePool.getNextOfNode(i);
+        position++;
+    }
+    if (i == NULL_INDEX || compare(data, nodePool.nodeData(i))) // not found
+        return NULL_INDEX;
+    return position;
+}
+
+// Definition of size()
+template <typename ElementType, typename Compare, int Capacity>
+int SortedArrayBasedList<ElementType, Compare, Capacity>::size() const
+{
+    return count;
+}
+
+// Definition of unique()
+template <typename ElementType, typename Compare, int Capacity>
+int SortedArrayBasedList<ElementType, Compare, Capacity>::unique()
+{
+    int removed = 0;
+    if (first == NULL_INDEX) // list is empty
+        return removed;
+
+    // Equal elements are adjacent: release every node equal to the one kept
+    // before it
+    int kept = first;
+    int curr = nodePool.getNextOfNode(kept);
+    while (curr != NULL_INDEX)
+    {
+        int next = nodePool.getNextOfNode(curr);
+        if (equal(nodePool.nodeData(kept), nodePool.nodeData(curr)))
+        {
+            nodePool.releaseNode(curr);
+            removed++;
+        }
+        else
+        {
+            nodePool.setNextOfNode(kept, curr);
+            kept = curr;
+        }
+        curr = next;
+    }
+    nodePool.setNextOfNode(kept, NULL_INDEX);
+    last = kept;
+    count -= removed;
+    return removed;
+}
+
+// Definition of setUnion()
+template <typename ElementType, typename Compare, int Capacity>
+bool SortedArrayBasedList<ElementType, Compare, Capacity>::setUnion(
+    const SortedArrayBasedList &other, SortedArrayBasedList &result) const
+{
+    result.clear();
+    const_iterator a = begin(), b = other.begin();
+
+    // Merge; an element in both lists is output once
+    while (a != end() && b != other.end())
+    {
+        bool ok;
+        if (compare(*a, *b))
+            ok = result.append(*a++);
+        else if (compare(*b, *a))
+            ok = result.append(*b++);
+        else
+        {
+            ok = result.append(*a++);
+            ++b;
+        }
+        if (!ok) // result is full
+            return false;
+    }
+
+    // Copy what remains of either list
+    for (; a != end(); ++a)
+        if (!result.append(*a))
+            return false;
+    for (; b != other.end(); ++b)
+        if (!result.append(*b))
+            return false;
+    return true;
+}
+
+// Definition of setIntersection()
+template <typename ElementType, typename Compare, int Capacity>
+bool SortedArrayBasedList<ElementType, Compare, Capacity>::setIntersection(
+    const SortedArrayBasedList &other, SortedArrayBasedList &result) const
+{
+    result.clear();
+    const_iterator a = begin(), b = other.begin();
+
+    // Output an element only when it is found in both lists
+    while (a != end() && b != other.end())
+    {
+        if (compare(*a, *b))
+            ++a;
+        else if (compare(*b, *a))
+            ++b;
+        else
+        {
+            if (!result.append(*a++)) // result is full
+                return false;
+            ++b;
+        }
+    }
+    return true;
+}
+
+// Definition of setDifference()
+template <typename ElementType, typename Compare, int Capacity>
+bool SortedArrayBasedList<ElementType, Compare, Capacity>::setDifference(
+    const SortedArrayBasedList &other, SortedArrayBasedList &result) const
+{
+    result.clear();
+    const_iterator a = begin(), b = other.begin();
+
+    // Output the elements of this list not matched by one of 'other'
+    while (a != end() && b != other.end())
+    {
+        if (compare(*a, *b))
+        {
+            if (!result.append(*a++)) // result is full
+                return false;
+        }
+        else if (compare(*b, *a))
+            ++b;
+        else
+        {
+            ++a;
+            ++b;
+        }
+    }
+    for (; a != end(); ++a)
+        if (!result.append(*a))
+            return false;
+    return true;
+}
+
+// Definition of display()
+template <typename ElementType, typename Compare, int Capacity>
+void SortedArrayBasedList<ElementType, Compare, Capacity>::display(ostream &out) const
+{
+    if (first == NULL_INDEX) // list is empty
+    {
+        out << "List is empty";
+    }
+    else
+    {
+        // Loop through the list
+        for (int i = first; i != NULL_INDEX; i = nodePool.getNextOfNode(i))
+        {
+            out << nodePool.nodeData(i);
+            if (nodePool.getNextOfNode(i) != NULL_INDEX) // check if not last node
+                out << ", ";
+        }
+    }
+    out << '\n';
+}
+
+// Definition of clear()
+template <typename ElementType, typename Compare, int Capacity>
+void SortedArrayBasedList<ElementType, Compare, Capacity>::clear()
+{
+    nodePool.reset(); // every node back on the free list
+    first = NULL_INDEX;
+    last = NULL_INDEX;
+    count = 0;
+}
+
+// Definition of begin()
+template <typename ElementType, typename Compare, int Capacity>
+typename SortedArrayBasedList<ElementType, Compare, Capacity>::const_iterator
+SortedArrayBasedList<ElementType, Compare, Capacity>::begin() const
+{
+    return const_iterator(&nodePool, first);
+}
+
+// Definition of end()
+template <typename ElementType, typename Compare, int Capacity>
+typename SortedArrayBasedList<ElementType, Compare, Capacity>::const_iterator
+SortedArrayBasedList<ElementType, Compare, Capacity>::end() const
+{
+    return const_iterator(&nodePool, NULL_INDEX);
+}
+
+// Definition of append()
+template <typename ElementType, typename Compare, int Capacity>
+bool SortedArrayBasedList<ElementType, Compare, Capacity>::append(const ElementType &value)
+{
+    int newNode = nodePool.acquireNode(); // get free node
+    if (newNode == NULL_INDEX)            // list is full
+        return false;
+
+    nodePool.setNodeData(newNode, value);
+    nodePool.setNextOfNode(newNode, NULL_INDEX);
+    if (last == NULL_INDEX) // list was empty
+        first = newNode;
+    else
+        nodePool.setNextOfNode(last, newNode);
+    last = newNode;
+    count++;
+    return true;
+}
+
+// Definition of equal()
+template <typename ElementType, typename Compare, int Capacity>
+bool SortedArrayBasedList<ElementType, Compare, Capacity>::equal(const ElementType &a,
+                                                                 const ElementType &b) const
+{
+    return !compare(a, b) && !compare(b, a);
+}
+
+#endif
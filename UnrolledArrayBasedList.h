@@ -0,0 +1,657 @@
+/*-- UnrolledArrayBasedList.h --------------------------------------------------
+    This header file defines the template class UnrolledArrayBasedList, an
+    unrolled variant of ArrayBasedList: every NodePool slot holds a small
+    array of up to BlockSize elements plus a count, instead of a single
+    element.
+
+    With small elements (like the int of tester.cpp) a Node of ArrayBasedList
+    spends as much memory on 'next' as on data, and every element costs a
+    dependent load. Here one 'next' is shared by a whole block, and search,
+    size and iteration scan contiguous elements, following one link per
+    block. Inserts and deletes shift elements inside one block only:
+        - a full block splits in two halves on insert (an insert at the end
+          of a full block starts a new block instead, so appends keep blocks
+          full);
+        - a block less than half full after a delete merges its next block
+          into itself when they fit in one, and an empty block is released.
+
+    Basic operations are:
+        Constructor: Constructs an empty list.
+        isEmpty: Check if list is empty.
+        insertAtPosition: Insert an element at a position.
+        insertAfterValue: Insert an element after the first occurrence of a
+                          target.
+        deleteAtPosition: Delete the element at a position.
+        deleteValue: Delete the first occurrence of a value.
+        search: Search for a value.
+        size: Returns the size of the list.
+        display: Print list content.
+        clear: Remove every element from the list.
+
+    Appender (nested class) adds elements at the end of a list in O(1) each,
+    filling every block before starting the next one.
+    const_iterator (nested class) walks the list in order, read-only.
+
+    Capacity is a template parameter (default CAPACITY) giving the number of
+    slots (blocks) in the NodePool, so the list holds at most
+    Capacity * BlockSize elements. BlockSize is a template parameter
+    (default UNROLLED_BLOCK_SIZE).
+
+    Class Invariant:
+        1. first stores the index of the first block, or NULL_INDEX if the
+           list is empty.
+        2. Every block in the list holds 1..BlockSize elements in
+           items[0..count - 1]; blocks are linked through their 'next' field.
+------------------------------------------------------------------------------*/
+
+#ifndef UNROLLEDARRAYBASEDLIST_H
+#define UNROLLEDARRAYBASEDLIST_H
+
+#include <cstddef>
+#include <iostream>
+#include <iterator>
+#include "NodePool.h"
+
+using namespace std;
+
+const int UNROLLED_BLOCK_SIZE = 14; // elements per slot (64-byte node for int)
+
+template <typename ElementType, int Capacity = CAPACITY,
+          int BlockSize = UNROLLED_BLOCK_SIZE>
+class UnrolledArrayBasedList
+{
+    static_assert(BlockSize >= 2, "a block must hold at least two elements");
+
+    /** Private class Block: data of a pool slot */
+    class Block
+    {
+    public:
+        ElementType items[BlockSize]; // elements, in order
+        int count;                    // number of elements in items
+    };
+
+public:
+    /** Public class Appender */
+    class Appender
+    {
+    public:
+        /******** Member Functions ********/
+
+        /***** Class constructor *****/
+        explicit Appender(UnrolledArrayBasedList &list);
+        /*----------------------------------------------------------------------
+            Construct an Appender for a list.
+
+            Precondition:  None.
+            Postcondition: The Appender remembers the last block of 'list'
+                           (found with one walk from first).
+        ----------------------------------------------------------------------*/
+
+        bool append(const ElementType &value);
+        /*----------------------------------------------------------------------
+            Add an element at the end of the list.
+
+            Precondition:  The last block of the list was not changed, other
+                           than by this Appender, since the Appender was
+                           constructed (changes before it are fine).
+            Postcondition: 'value' is stored after the last element in O(1)
+                           and true is returned; false if the last block is
+                           full and the NodePool is full.
+        ----------------------------------------------------------------------*/
+
+    private:
+        /******** Data members ********/
+        UnrolledArrayBasedList &list; // list being extended
+        int last;                     // index of the last block, or NULL_INDEX
+    };
+
+    /** Public class const_iterator */
+    class const_iterator
+    {
+    public:
+        typedef forward_iterator_tag iterator_category;
+        typedef ElementType value_type;
+        typedef ptrdiff_t difference_type;
+        typedef const ElementType *pointer;
+        typedef const ElementType &reference;
+
+        /******** Member Functions ********/
+
+        /***** Class constructor *****/
+        const_iterator();
+        /*----------------------------------------------------------------------
+            Construct an iterator equal to end() of any list.
+
+            Precondition:  None.
+            Postcondition: The iterator refers to no element.
+        ----------------------------------------------------------------------*/
+
+        reference operator*() const;
+        pointer operator->() const;
+        /*----------------------------------------------------------------------
+            Access the element the iterator refers to.
+
+            Precondition:  The iterator is not end().
+            Postcondition: Returns the current element.
+        ----------------------------------------------------------------------*/
+
+        const_iterator &operator++();
+        const_iterator operator++(int);
+        /*----------------------------------------------------------------------
+            Move to the next element.
+
+            Precondition:  The iterator is not end().
+            Postcondition: The iterator refers to the next element, or is
+                           end() if it was at the last one.
+        ----------------------------------------------------------------------*/
+
+        bool operator==(const const_iterator &other) const;
+        bool operator!=(const const_iterator &other) const;
+        /*----------------------------------------------------------------------
+            Compare two iterators.
+
+            Precondition:  Both iterators belong to the same list.
+            Postcondition: Returns whether they refer to the same element.
+        ----------------------------------------------------------------------*/
+
+    private:
+        friend class UnrolledArrayBasedList;
+        const_iterator(const NodePool<Block, Capacity> *pool, int node);
+
+        /******** Data members ********/
+        const NodePool<Block, Capacity> *pool; // pool of the list
+        int node;                              // current block
+        int offset;                            // current element in the block
+    };
+
+    /******** Member Functions ********/
+
+    /***** Class constructor *****/
+    UnrolledArrayBasedList();
+    /*--------------------------------------------------------------------------
+        Construct an empty UnrolledArrayBasedList.
+
+        Precondition:  None.
+        Postcondition: An empty list is constructed; first is NULL_INDEX.
+    --------------------------------------------------------------------------*/
+
+    bool isEmpty() const;
+    /*--------------------------------------------------------------------------
+        Check if the list is empty.
+
+        Precondition:  None
+        Postcondition: Returns true if the list has no elements.
+------------------------------------------------------------------------------*/
+
+    bool insertAtPosition(const ElementType &value, int position);
+    /*--------------------------------------------------------------------------
+        Insert a new element at a specified position in the list.
+
+        Precondition:  0 <= position <= size().
+        Postcondition: 'value' is inserted at 'position' and true is returned,
+                       walking one link per block. Returns false if position
+                       is invalid, or if a block must split and the NodePool
+                       is full.
+------------------------------------------------------------------------------*/
+
+    bool insertAfterValue(const ElementType &value, const ElementType &target);
+    /*--------------------------------------------------------------------------
+        Insert a new element after the first occurrence of a target.
+
+        Precondition:  None.
+        Postcondition: 'value' is inserted right after target and true is
+                       returned; false if target is not found, or if a block
+                       must split and the NodePool is full.
+------------------------------------------------------------------------------*/
+
+    bool deleteAtPosition(int position);
+    /*--------------------------------------------------------------------------
+        Delete the element at the specified position in the list.
+
+        Precondition:  0 <= position < size().
+        Postcondition: The element is removed and true is returned; false if
+                       position is invalid. Blocks merge or are released as
+                       described above.
+------------------------------------------------------------------------------*/
+
+    bool deleteValue(const ElementType &value);
+    /*--------------------------------------------------------------------------
+        Remove the first occurrence of a value from the list.
+
+        Precondition:  None.
+        Postcondition: Returns true if the value was found and removed.
+------------------------------------------------------------------------------*/
+
+    int search(const ElementType &data) const;
+    /*--------------------------------------------------------------------------
+        Search for the first occurrence of a value in the list.
+
+        Precondition:  None
+        Postcondition: Returns the logical position of the first element
+                       equal to 'data', or NULL_INDEX if it is not found.
+------------------------------------------------------------------------------*/
+
+    int size() const;
+    /*--------------------------------------------------------------------------
+        Returns the size of the list.
+
+        Precondition:  None.
+        Postcondition: List size is returned, adding one count per block.
+------------------------------------------------------------------------------*/
+
+    void display(ostream &out) const;
+    /*--------------------------------------------------------------------------
+        Display all elements in the list in order.
+
+        Precondition:  None
+        Postcondition: Outputs all elements, separated by ", ", to 'out', or
+                       "List is empty", followed by '\n'.
+------------------------------------------------------------------------------*/
+
+    void clear();
+    /*--------------------------------------------------------------------------
+        Remove every element from the list.
+
+        Precondition:  None.
+        Postcondition: The list is empty and the NodePool is reset.
+------------------------------------------------------------------------------*/
+
+    const_iterator begin() const;
+    const_iterator end() const;
+    /*--------------------------------------------------------------------------
+        Get an iterator to the first element / the past-the-end iterator.
+
+        Precondition:  None.
+        Postcondition: Returns the iterator.
+------------------------------------------------------------------------------*/
+
+private:
+    bool insertInBlock(int node, int offset, const ElementType &value);
+    /*--------------------------------------------------------------------------
+        Insert 'value' at 'offset' in a block, splitting it if it is full.
+
+        Precondition:  node is a block of the list; 0 <= offset <= its count.
+        Postcondition: Returns true on success, false if a split needs a
+                       node and the NodePool is full.
+------------------------------------------------------------------------------*/
+
+    void removeFromBlock(int prev, int node, int offset);
+    /*--------------------------------------------------------------------------
+        Remove the element at 'offset' of a block, then release the block if
+        it is empty or merge its next block into it on underflow.
+
+        Precondition:  node is a block of the list, prev the block before it
+                       (NULL_INDEX if node is first); 0 <= offset < count.
+        Postcondition: The element is removed.
+------------------------------------------------------------------------------*/
+
+    NodePool<Block, Capacity> nodePool; // blocks of elements
+    int first;                          // first block in the list
+
+}; // end of class declaration
+
+/**************** FUNCTION DEFINITIONS ****************************************/
+
+// Definition of Appender constructor
+template <typename ElementType, int Capacity, int BlockSize>
+UnrolledArrayBasedList<ElementType, Capacity, BlockSize>::Appender::Appender(UnrolledArrayBasedList &list)
+    : list(list), last(list.first)
+{
+    // Walk once to the last block
+    if (last != NULL_INDEX)
+    {
+        while (list.nodePool.getNextOfNode(last) != NULL_INDEX)
+            last = list.nodePool.getNextOfNode(last);
+    }
+}
+
+// Definition of Appender append()
+template <typename ElementType, int Capacity, int BlockSize>
+bool UnrolledArrayBasedList<ElementType, Capacity, BlockSize>::Appender::append(const ElementType &value)
+{
+    if (last == NULL_INDEX) // list was empty
+    {
+        if (!list.insertAtPosition(value, 0))
+            return false;
+        last = list.first;
+        return true;
+    }
+
+    if (!list.insertInBlock(last, list.nodePool.nodeData(last).count, value))
+        return false;
+    if (list.nodePool.getNextOfNode(last) != NULL_INDEX) // a new block was started
+        last = list.nodePool.getNextOfNode(last);
+    return true;
+}
+
+// Definition of const_iterator no-arg constructor
+template <typename ElementType, int Capacity, int BlockSize>
+UnrolledArrayBasedList<ElementType, Capacity, BlockSize>::const_iterator::const_iterator()
+    : pool(nullptr), node(NULL_INDEX), offset(0) {}
+
+// Definition of const_iterator constructor with pool and node
+template <typename ElementType, int Capacity, int BlockSize>
+UnrolledArrayBasedList<ElementType, Capacity, BlockSize>::const_iterator::const_iterator(
+    const NodePool<Block, Capacity> *pool, int node)
+    : pool(pool), node(node), offset(0) {}
+
+// Definition of const_iterator operator*()
+template <typename ElementType, int Capacity, int BlockSize>
+typename UnrolledArrayBasedList<ElementType, Capacity, BlockSize>::const_iterator::reference
+UnrolledArrayBasedList<ElementType, Capacity, BlockSize>::const_iterator::operator*() const
+{
+    return pool->nodeData(node).items[offset];
+}
+
+// Definition of const_iterator operator->()
+template <typename ElementType, int Capacity, int BlockSize>
+typename UnrolledArrayBasedList<ElementType, Capacity, BlockSize>::const_iterator::pointer
+UnrolledArrayBasedList<ElementType, Capacity, BlockSize>::const_iterator::operator->() const
+{
+    return &pool->nodeData(node).items[offset];
+}
+
+// Definition of const_iterator prefix operator++()
+template <typename ElementType, int Capacity, int BlockSize>
+typename UnrolledArrayBasedList<ElementType, Capacity, BlockSize>::const_iterator &
+UnrolledArrayBasedList<ElementType, Capacity, BlockSize>::const_iterator::operator++()
+{
+    if (++offset == pool->nodeData(node).count) // end of block, go to next one
+    {
+        node = pool->getNextOfNode(node);
+        offset = 0;
+    }
+    return *this;
+}
+
+// Definition of const_iterator postfix operator++()
+template <typename ElementType, int Capacity, int BlockSize>
+typename UnrolledArrayBasedList<ElementType, Capacity, BlockSize>::const_iterator
+UnrolledArrayBasedList<ElementType, Capacity, BlockSize>::const_iterator::operator++(int)
+{
+    const_iterator old = *this;
+    ++*this;
+    return old;
+}
+
+// Definition of const_iterator operator==()
+template <typename ElementType, int Capacity, int BlockSize>
+bool UnrolledArrayBasedList<ElementType, Capacity, BlockSize>::const_iterator::operator==(
+    const const_iterator &other) const
+{
+    return node == other.node && offset == other.offset;
+}
+
+// Definition of const_iterator operator!=()
+template <typename ElementType, int Capacity, int BlockSize>
+bool UnrolledArrayBasedList<ElementType, Capacity, BlockSize>::const_iterator::operator!=(
+    const const_iterator &other) const
+{
+    return !(*this == other);
+}
+
+// Definition of constructor
+template <typename ElementType, int Capacity, int BlockSize>
+UnrolledArrayBasedList<ElementType, Capacity, BlockSize>::UnrolledArrayBasedList()
+    : first(NULL_INDEX) {}
+
+// Definition of isEmpty()
+template <typename ElementType, int Capacity, int BlockSize>
+bool UnrolledArrayBasedList<ElementType, Capacity, BlockSize>::isEmpty() const
+{
+    return first == NULL_INDEX;
+}
+
+// Definition of insertAtPosition()
+template <typename ElementType, int Capacity, int BlockSize>
+bool UnrolledArrayBasedList<ElementType, Capacity, BlockSize>::insertAtPosition(
+    const ElementType &value, int position)
+{
+    if (position < 0) // Invalid index
+        return false;
+
+    if (first == NULL_INDEX) // List is empty
+    {
+        if (position != 0) // Can not insert in the middle of an empty list
+            return false;
+
+        int node = nodePool.acquireNode();
+        if (node == NULL_INDEX) // NodePool is full
+            return false;
+        Block &block = nodePool.nodeData(node);
+        block.items[0] = value;
+        block.count = 1;
+        first = node;
+        return true;
+    }
+
+    // Find the block holding position (offset == count appends to it)
+    int node = first;
+    int offset = position;
+    while (offset > nodePool.nodeData(node).count)
+    {
+        offset -= nodePool.nodeData(node).count;
+        node = nodePool.getNextOfNode(node);
+        if (node == NULL_INDEX) // position not reached (list is too small)
+            return false;
+    }
+    return insertInBlock(node, offset, value);
+}
+
+// Definition of insertAfterValue()
+template <typename ElementType, int Capacity, int BlockSize>
+bool UnrolledArrayBasedList<ElementType, Capacity, BlockSize>::insertAfterValue(
+    const ElementType &value, const ElementType &target)
+{
+    // Scan every block for target
+    for (int node = first; node != NULL_INDEX; node = nodePool.getNextOfNode(node))
+    {
+        const Block &block = nodePool.nodeData(node);
+        for (int i = 0; i < block.count; i++)
+        {
+            if (block.items[i] == target) // Found target, now insert after it
+                return insertInBlock(node, i + 1, value);
+        }
+    }
+    return false; // Target not found
+}
+
+// Definition of deleteAtPosition()
+template <typename ElementType, int Capacity, int BlockSize>
+bool UnrolledArrayBasedList<ElementType, Capacity, BlockSize>::deleteAtPosition(int position)
+{
+    if (position < 0) // Invalid index
+        return false;
+
+    // Find the block holding position
+    int prev = NULL_INDEX;
+    int node = first;
+    int offset = position;
+    while (node != NULL_INDEX && offset >= nodePool.nodeData(node).count)
+    {
+        offset -= nodePool.nodeData(node).count;
+        prev = node;
+        node = nodePool.getNextOfNode(node);
+    }
+    if (node == NULL_INDEX) // position past the end (or list is empty)
+        return false;
+
+    removeFromBlock(prev, node, offset);
+    return true;
+}
+
+// Definition of deleteValue()
+template <typename ElementType, int Capacity, int BlockSize>
+bool UnrolledArrayBasedList<ElementType, Capacity, BlockSize>::deleteValue(const ElementType &value)
+{
+    int prev = NULL_INDEX; // block before node
+    for (int node = first; node != NULL_INDEX; node = nodePool.getNextOfNode(node))
+    {
+        const Block &block = nodePool.nodeData(node);
+        for (int i = 0; i < block.count; i++)
+        {
+            if (block.items[i] == value) // found value
+            {
+                removeFromBlock(prev, node, i);
+                return true;
+            }
+        }
+        prev = node;
+    }
+    return false; // Value not found
+}
+
+// Definition of search()
+template <typename ElementType, int Capacity, int BlockSize>
+int UnrolledArrayBasedList<ElementType, Capacity, BlockSize>::search(const ElementType &data) const
+{
+    int position = 0; // logical position of the first element of node
+
+    // Scan every block; elements of a block are contiguous
+    for (int node = first; node != NULL_INDEX; node = nodePool.getNextOfNode(node))
+    {
+        const Block &block = nodePool.nodeData(node);
+        for (int i = 0; i < block.count; i++)
+        {
+            if (block.items[i] == data) // found data
+                return position + i;
+        }
+        position += block.count;
+    }
+    return NULL_INDEX; // data not found
+}
+
+// Definition of size()
+template <typename ElementType, int Capacity, int BlockSize>
+int UnrolledArrayBasedList<ElementType, Capacity, BlockSize>::size() const
+{
+    int size = 0; // size of the list
+
+    // Add the count of every block
+    for (int node = first; node != NULL_INDEX; node = nodePool.getNextOfNode(node))
+        size += nodePool.nodeData(node).count;
+    return size;
+}
+
+// Definition of display()
+template <typename ElementType, int Capacity, int BlockSize>
+void UnrolledArrayBasedList<ElementType, Capacity, BlockSize>::display(ostream &out) const
+{
+    if (first == NULL_INDEX) // list is empty
+    {
+        out << "List is empty";
+    }
+    else
+    {
+        for (const_iterator i = begin(); i != end(); ++i)
+        {
+            if (i != begin()) // separate from the previous element
+                out << ", ";
+            out << *i;
+        }
+    }
+    out << '\n';
+}
+
+// Definition of clear()
+template <typename ElementType, int Capacity, int BlockSize>
+void UnrolledArrayBasedList<ElementType, Capacity, BlockSize>::clear()
+{
+    nodePool.reset(); // every block back on the free list
+    first = NULL_INDEX;
+}
+
+// Definition of begin()
+template <typename ElementType, int Capacity, int BlockSize>
+typename UnrolledArrayBasedList<ElementType, Capacity, BlockSize>::const_iterator
+UnrolledArrayBasedList<ElementType, Capacity, BlockSize>::begin() const
+{
+    return const_iterator(&nodePool, first);
+}
+
+// Definition of end()
+template <typename ElementType, int Capacity, int BlockSize>
+typename UnrolledArrayBasedList<ElementType, Capacity, BlockSize>::const_iterator
+UnrolledArrayBasedList<ElementType, Capacity, BlockSize>::end() const
+{
+    return const_iterator(&nodePool, NULL_INDEX);
+}
+
+// Definition of insertInBlock()
+template <typename ElementType, int Capacity, int BlockSize>
+bool UnrolledArrayBasedList<ElementType, Capacity, BlockSize>::insertInBlock(
+    int node, int offset, const ElementType &value)
+{
+    if (nodePool.nodeData(node).count == BlockSize) // block is full
+    {
+        int extra = nodePool.acquireNode(); // new block linked after node
+        if (extra == NULL_INDEX)            // NodePool is full
+            return false;
+
+        Block &block = nodePool.nodeData(node);
+        Block &other = nodePool.nodeData(extra);
+        if (offset == BlockSize) // insert at the end: start the new block
+        {
+            other.count = 0;
+        }
+        else // split: move the upper half to the new block
+        {
+            int half = BlockSize / 2;
+            for (int i = half; i < BlockSize; i++)
+                other.items[i - half] = block.items[i];
+            other.count = BlockSize - half;
+            block.count = half;
+        }
+        nodePool.setNextOfNode(extra, nodePool.getNextOfNode(node));
+        nodePool.setNextOfNode(node, extra);
+
+        if (offset >= block.count) // position is in the new block
+        {
+            offset -= block.count;
+            node = extra;
+        }
+    }
+
+    // Shift the elements after offset and store value
+    Block &block = nodePool.nodeData(node);
+    for (int i = block.count; i > offset; i--)
+        block.items[i] = block.items[i - 1];
+    block.items[offset] = value;
+    block.count++;
+    return true;
+}
+
+// Definition of removeFromBlock()
+template <typename ElementType, int Capacity, int BlockSize>
+void UnrolledArrayBasedList<ElementType, Capacity, BlockSize>::removeFromBlock(
+    int prev, int node, int offset)
+{
+    // Shift the elements after offset down
+    Block &block = nodePool.nodeData(node);
+    for (int i = offset + 1; i < block.count; i++)
+        block.items[i - 1] = block.items[i];
+    block.count--;
+
+    int next = nodePool.getNextOfNode(node);
+    if (block.count == 0) // release the empty block
+    {
+        if (prev == NULL_INDEX)
+            first = next;
+        else
+            nodePool.setNextOfNode(prev, next);
+        nodePool.releaseNode(node);
+    }
+    else if (block.count < BlockSize / 2 && next != NULL_INDEX &&
+             block.count + nodePool.nodeData(next).count <= BlockSize)
+    {
+        // Underflow: merge the next block into this one
+        const Block &other = nodePool.nodeData(next);
+        for (int i = 0; i < other.count; i++)
+            block.items[block.count + i] = other.items[i];
+        block.count += other.count;
+        nodePool.setNextOfNode(node, nodePool.getNextOfNode(next));
+        nodePool.releaseNode(next);
+    }
+}
+
+#endif
@@ -0,0 +1,636 @@
+/*-- benchmark.cpp -------------------------------------------------------------
+  Self-contained benchmark of ArrayBasedList<T> and UnrolledArrayBasedList<T>
+  against std::list, std::forward_list and std::vector.
+
+  Every container runs the same workload for each payload type and size:
+    insertAtPosition  insert at a random position
+    insertAfterValue  insert after a random element
+    deleteValue       delete a random element by value
+    search            find a random element by value
+    size              count the elements
+    iteration         visit every element in order
+    sort              sort the elements (ArrayBasedList only up to
+                      MAX_SORT_SIZE, since its sort is a bubble sort;
+                      not run for UnrolledArrayBasedList, which has none)
+
+  Payloads: int, string (24 characters, so it does not fit the small string
+  buffer) and a 64-byte struct. Sizes: 10, 100,..., 10^7 elements.
+
+  ArrayBasedList is run on a "fresh" pool (logical order equal to physical
+  order) and on a "churned" pool (elements scattered over the pool by
+  repeatedly rebuilding the list from the front and the back, as a long
+  running list would be). From PLACEMENT_MIN_SIZE elements on, the churned
+  list is also run in memory of a HugePageResource, on 4 KB pages and on
+  huge pages, to show what TLB misses cost when walking a scattered pool
+  (container "ArrayBasedList (4k pages)" / "ArrayBasedList (huge pages)").
+
+  Usage:
+    benchmark [--json] [--max-size N]
+
+ * Precondition: None.
+
+ * Postcondition: One result row per (container, payload, size, pool,
+     operation) is printed to cout, as CSV (default) or as a JSON array.
+     Returns 0, or 1 if the arguments are invalid.
+
+  NOTES:
+    The default maximum size is 10^6; pass --max-size 10000000 for the
+    largest runs (they need several GB of memory).
+    Build with: g++ -std=c++17 -O2 -o benchmark benchmark.cpp
+------------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <forward_list>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "ArrayBasedList.h"
+#include "HugePageResource.h"
+#include "UnrolledArrayBasedList.h"
+
+using namespace std;
+
+const long long MAX_VISITS = 100000000; // node visits per measured operation
+const int MAX_REPS = 10000;             // repetitions of one operation
+const int MIN_REPS = 10;
+const int MAX_SORT_SIZE = 10000; // largest ArrayBasedList sorted (O(n^2))
+const int CHURN_PASSES = 12;     // rebuild passes of a churned pool
+const int PLACEMENT_MIN_SIZE = 100000; // smallest size run with page placements
+
+/** 64-byte payload */
+struct Payload64
+{
+    long long key;
+    char padding[56];
+
+    bool operator==(const Payload64 &other) const { return key == other.key; }
+    bool operator!=(const Payload64 &other) const { return key != other.key; }
+    bool operator>(const Payload64 &other) const { return key > other.key; }
+    bool operator<(const Payload64 &other) const { return key < other.key; }
+};
+
+/** One benchmark measurement */
+struct Result
+{
+    string container;
+    string payload;
+    int size;
+    string pool;
+    string operation;
+    int operations;
+    double nsPerOp;
+};
+
+/******** Payload helpers ********/
+
+int makeValue(long long key, int *) { return (int)key; }
+string makeValue(long long key, string *)
+{
+    string value = to_string(key);
+    return string(24 - value.size(), '0') + value; // 24 characters
+}
+Payload64 makeValue(long long key, Payload64 *)
+{
+    Payload64 value;
+    value.key = key;
+    memset(value.padding, 0, sizeof(value.padding));
+    return value;
+}
+
+long long keyOf(int value) { return value; }
+long long keyOf(const string &value) // reads the characters, not just the size
+{
+    return value.empty() ? 0 : value.front() * 256 + value.back();
+}
+long long keyOf(const Payload64 &value) { return value.key; }
+
+// Build a payload of type T from a key; distinct keys give distinct values
+template <typename T>
+T value(long long key)
+{
+    return makeValue(key, (T *)nullptr);
+}
+
+/******** List placements ********/
+
+/** Placement of an ArrayBasedList on the heap */
+class HeapPlacement
+{
+public:
+    static pmr::memory_resource *resource() { return pmr::new_delete_resource(); }
+    static string suffix() { return ""; }
+};
+
+/** Placement of an ArrayBasedList in memory of a HugePageResource */
+template <HugePageMode Mode>
+class PagePlacement
+{
+public:
+    static pmr::memory_resource *resource()
+    {
+        static HugePageResource pages(Mode);
+        return &pages;
+    }
+    static string suffix() { return Mode == HUGE_PAGES_NONE ? " (4k pages)" : " (huge pages)"; }
+};
+
+/******** Container adapters ********/
+
+/** ArrayBasedList adapter; Capacity leaves room for MAX_REPS extra nodes */
+template <typename T, int Capacity, typename Placement = HeapPlacement>
+class ListAdapter
+{
+    typedef ArrayBasedList<T, Capacity> List;
+
+public:
+    // The list is too big for the stack: place it in memory of Placement
+    ListAdapter()
+        : list(new (Placement::resource()->allocate(sizeof(List), alignof(List))) List) {}
+    ListAdapter(const ListAdapter &) = delete;
+    ~ListAdapter()
+    {
+        list->~List();
+        Placement::resource()->deallocate(list, sizeof(List), alignof(List));
+    }
+
+    string name() const { return "ArrayBasedList" + Placement::suffix(); }
+
+    void build(int n, bool churned, mt19937_64 &random)
+    {
+        typename ArrayBasedList<T, Capacity>::Appender appender(*list);
+        for (int i = 0; i < n; i++)
+            appender.append(value<T>(i));
+
+        // Each pass empties the list from the front, then rebuilds it by
+        // placing each node it gets back at the front or at the back at
+        // random, which scatters neighbours over the whole pool
+        for (int pass = 0; churned && pass < CHURN_PASSES; pass++)
+        {
+            vector<T> values(list->begin(), list->end());
+            while (!list->isEmpty())
+                list->deleteAtPosition(0);
+
+            list->insertAtPosition(values[0], 0);
+            typename ArrayBasedList<T, Capacity>::Appender back(*list);
+            for (int i = 1; i < n; i++)
+            {
+                if (random() & 1)
+                    list->insertAtPosition(values[i], 0);
+                else
+                    back.append(values[i]);
+            }
+        }
+    }
+
+    void insertAt(const T &v, int position) { list->insertAtPosition(v, position); }
+    void insertAfter(const T &v, const T &target) { list->insertAfterValue(v, target, false); }
+    void deleteValue(const T &v) { list->deleteValue(v); }
+    int search(const T &v) const { return list->search(v); }
+    int size() const { return list->size(); }
+    void sort() { list->sort(); }
+    bool canSort(int n) const { return n <= MAX_SORT_SIZE; }
+
+    long long iterate() const
+    {
+        long long sum = 0;
+        for (const T &element : *list)
+            sum += keyOf(element);
+        return sum;
+    }
+
+private:
+    List *list;
+};
+
+/** UnrolledArrayBasedList adapter; Capacity counts blocks */
+template <typename T, int Capacity>
+class UnrolledAdapter
+{
+public:
+    UnrolledAdapter() : list(new UnrolledArrayBasedList<T, Capacity>) {}
+
+    string name() const { return "UnrolledArrayBasedList"; }
+
+    void build(int n, bool, mt19937_64 &)
+    {
+        typename UnrolledArrayBasedList<T, Capacity>::Appender appender(*list);
+        for (int i = 0; i < n; i++)
+            appender.append(value<T>(i));
+    }
+
+    void insertAt(const T &v, int position) { list->insertAtPosition(v, position); }
+    void insertAfter(const T &v, const T &target) { list->insertAfterValue(v, target); }
+    void deleteValue(const T &v) { list->deleteValue(v); }
+    int search(const T &v) const { return list->search(v); }
+    int size() const { return list->size(); }
+    void sort() {}
+    bool canSort(int) const { return false; }
+
+    long long iterate() const
+    {
+        long long sum = 0;
+        for (const T &element : *list)
+            sum += keyOf(element);
+        return sum;
+    }
+
+private:
+    unique_ptr<UnrolledArrayBasedList<T, Capacity>> list; // too big for the stack
+};
+
+/** std::list adapter */
+template <typename T>
+class StdListAdapter
+{
+public:
+    string name() const { return "std::list"; }
+
+    void build(int n, bool, mt19937_64 &)
+    {
+        for (int i = 0; i < n; i++)
+            elements.push_back(value<T>(i));
+    }
+
+    void insertAt(const T &v, int position)
+    {
+        typename std::list<T>::iterator it = elements.begin();
+        advance(it, position);
+        elements.insert(it, v);
+    }
+    void insertAfter(const T &v, const T &target)
+    {
+        typename std::list<T>::iterator it = find(elements.begin(), elements.end(), target);
+        if (it != elements.end())
+            elements.insert(++it, v);
+    }
+    void deleteValue(const T &v)
+    {
+        typename std::list<T>::iterator it = find(elements.begin(), elements.end(), v);
+        if (it != elements.end())
+            elements.erase(it);
+    }
+    int search(const T &v) const
+    {
+        typename std::list<T>::const_iterator it = find(elements.begin(), elements.end(), v);
+        return it == elements.end() ? -1 : distance(elements.begin(), it);
+    }
+    int size() const { return elements.size(); }
+    void sort() { elements.sort(); }
+    bool canSort(int) const { return true; }
+
+    long long iterate() const
+    {
+        long long sum = 0;
+        for (const T &element : elements)
+            sum += keyOf(element);
+        return sum;
+    }
+
+private:
+    std::list<T> elements;
+};
+
+/** std::forward_list adapter */
+template <typename T>
+class ForwardListAdapter
+{
+public:
+    string name() const { return "std::forward_list"; }
+
+    void build(int n, bool, mt19937_64 &)
+    {
+        typename forward_list<T>::iterator last = elements.before_begin();
+        for (int i = 0; i < n; i++)
+            last = elements.insert_after(last, value<T>(i));
+    }
+
+    void insertAt(const T &v, int position)
+    {
+        typename forward_list<T>::iterator it = elements.before_begin();
+        advance(it, position);
+        elements.insert_after(it, v);
+    }
+    void insertAfter(const T &v, const T &target)
+    {
+        typename forward_list<T>::iterator it = find(elements.begin(), elements.end(), target);
+        if (it != elements.end())
+            elements.insert_after(it, v);
+    }
+    void deleteValue(const T &v)
+    {
+        typename forward_list<T>::iterator previous = elements.before_begin();
+        for (typename forward_list<T>::iterator it = elements.begin(); it != elements.end();
+             previous = it++)
+        {
+            if (*it == v)
+            {
+                elements.erase_after(previous);
+                return;
+            }
+        }
+    }
+    int search(const T &v) const
+    {
+        typename forward_list<T>::const_iterator it = find(elements.begin(), elements.end(), v);
+        return it == elements.end() ? -1 : distance(elements.begin(), it);
+    }
+    int size() const { return distance(elements.begin(), elements.end()); }
+    void sort() { elements.sort(); }
+    bool canSort(int) const { return true; }
+
+    long long iterate() const
+    {
+        long long sum = 0;
+        for (const T &element : elements)
+            sum += keyOf(element);
+        return sum;
+    }
+
+private:
+    forward_list<T> elements;
+};
+
+/** std::vector adapter */
+template <typename T>
+class VectorAdapter
+{
+public:
+    string name() const { return "std::vector"; }
+
+    void build(int n, bool, mt19937_64 &)
+    {
+        elements.reserve(n);
+        for (int i = 0; i < n; i++)
+            elements.push_back(value<T>(i));
+    }
+
+    void insertAt(const T &v, int position) { elements.insert(elements.begin() + position, v); }
+    void insertAfter(const T &v, const T &target)
+    {
+        typename std::vector<T>::iterator it = find(elements.begin(), elements.end(), target);
+        if (it != elements.end())
+            elements.insert(it + 1, v);
+    }
+    void deleteValue(const T &v)
+    {
+        typename std::vector<T>::iterator it = find(elements.begin(), elements.end(), v);
+        if (it != elements.end())
+            elements.erase(it);
+    }
+    int search(const T &v) const
+    {
+        typename std::vector<T>::const_iterator it = find(elements.begin(), elements.end(), v);
+        return it == elements.end() ? -1 : it - elements.begin();
+    }
+    int size() const { return elements.size(); }
+    void sort() { std::sort(elements.begin(), elements.end()); }
+    bool canSort(int) const { return true; }
+
+    long long iterate() const
+    {
+        long long sum = 0;
+        for (const T &element : elements)
+            sum += keyOf(element);
+        return sum;
+    }
+
+private:
+    std::vector<T> elements;
+};
+
+/******** Workload ********/
+
+volatile long long sink; // keeps results of pure operations alive
+
+template <typename Adapter, typename T>
+void runWorkload(const string &payload, int n, bool churned,
+                 vector<Result> &results);
+/*------------------------------------------------------------------------------
+    Run every operation on a container of n elements.
+
+    Precondition:  n >= 1.
+    Postcondition: One Result per operation is added to results. The
+                   container holds n elements at the start of each operation.
+------------------------------------------------------------------------------*/
+
+template <typename T, int Size>
+void runSize(const string &payload, int maxSize, vector<Result> &results);
+/*------------------------------------------------------------------------------
+    Run the workload on every container for one payload and size.
+
+    Precondition:  None.
+    Postcondition: Nothing happens if Size > maxSize.
+------------------------------------------------------------------------------*/
+
+template <typename T>
+void runPayload(const string &payload, int maxSize, vector<Result> &results);
+/*------------------------------------------------------------------------------
+    Run the workload for one payload at every size up to maxSize.
+------------------------------------------------------------------------------*/
+
+void printResults(const vector<Result> &results, bool json);
+/*------------------------------------------------------------------------------
+    Print results as CSV (with a header line) or as a JSON array.
+------------------------------------------------------------------------------*/
+
+int main(int argc, char *argv[])
+{
+    bool json = false;     // output format
+    int maxSize = 1000000; // largest size run
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--json") == 0)
+            json = true;
+        else if (strcmp(argv[i], "--max-size") == 0 && i + 1 < argc)
+            maxSize = atoi(argv[++i]);
+        else
+        {
+            cerr << "Usage: " << argv[0] << " [--json] [--max-size N]\n";
+            return 1;
+        }
+    }
+
+    vector<Result> results;
+    runPayload<int>("int", maxSize, results);
+    runPayload<string>("string24", maxSize, results);
+    runPayload<Payload64>("struct64", maxSize, results);
+
+    printResults(results, json);
+    return 0;
+}
+
+// Definition of runWorkload()
+template <typename Adapter, typename T>
+void runWorkload(const string &payload, int n, bool churned,
+                 vector<Result> &results)
+{
+    mt19937_64 random(n); // same random choices for every container
+    Adapter container;
+    container.build(n, churned, random);
+
+    long long reps = MAX_VISITS / n; // cheaper operations on small sizes
+    int count = (int)max<long long>(MIN_REPS, min<long long>(MAX_REPS, reps));
+    long long nextKey = n; // keys of new elements
+
+    // Random existing values and positions, drawn before timing
+    vector<T> targets, inserted;
+    vector<int> positions;
+    for (int i = 0; i < count; i++)
+    {
+        targets.push_back(value<T>(random() % n));
+        positions.push_back(random() % (n + 1));
+        inserted.push_back(value<T>(nextKey++));
+    }
+
+    Result result = {container.name(), payload, n,
+                     churned ? "churned" : "fresh", "", count, 0};
+    if (container.name().compare(0, 5, "std::") == 0)
+        result.pool = "n/a"; // no NodePool
+    chrono::steady_clock::time_point start;
+
+    // Report the time since start as the average of 'count' operations
+    auto record = [&](const string &operation) {
+        chrono::duration<double, nano> elapsed = chrono::steady_clock::now() - start;
+        result.operation = operation;
+        result.nsPerOp = elapsed.count() / result.operations;
+        results.push_back(result);
+    };
+
+    // Insertions run in batches of at most a tenth of n, each followed by
+    // deleting what it inserted, so the size stays close to n
+    int batch = max(1, min(count, n / 10));
+    chrono::duration<double, nano> insertAtTime(0), deleteTime(0), insertAfterTime(0);
+
+    for (int done = 0; done < count; done += batch)
+    {
+        int last = min(count, done + batch); // end of this batch
+
+        start = chrono::steady_clock::now();
+        for (int i = done; i < last; i++)
+            container.insertAt(inserted[i], positions[i]);
+        insertAtTime += chrono::steady_clock::now() - start;
+
+        start = chrono::steady_clock::now();
+        for (int i = done; i < last; i++)
+            container.deleteValue(inserted[i]);
+        deleteTime += chrono::steady_clock::now() - start;
+
+        start = chrono::steady_clock::now();
+        for (int i = done; i < last; i++)
+            container.insertAfter(inserted[i], targets[i]);
+        insertAfterTime += chrono::steady_clock::now() - start;
+
+        for (int i = done; i < last; i++) // back to n elements (not measured)
+            container.deleteValue(inserted[i]);
+    }
+
+    result.operation = "insertAtPosition";
+    result.nsPerOp = insertAtTime.count() / count;
+    results.push_back(result);
+    result.operation = "deleteValue";
+    result.nsPerOp = deleteTime.count() / count;
+    results.push_back(result);
+    result.operation = "insertAfterValue";
+    result.nsPerOp = insertAfterTime.count() / count;
+    results.push_back(result);
+
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < count; i++)
+        sink = container.search(targets[i]);
+    record("search");
+
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < count; i++)
+        sink = container.size();
+    record("size");
+
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < count; i++)
+        sink = container.iterate();
+    record("iteration");
+
+    if (container.canSort(n))
+    {
+        result.operations = 1;
+        start = chrono::steady_clock::now();
+        container.sort();
+        record("sort");
+    }
+}
+
+// Definition of runSize()
+template <typename T, int Size>
+void runSize(const string &payload, int maxSize, vector<Result> &results)
+{
+    if (Size > maxSize)
+        return;
+
+    runWorkload<ListAdapter<T, Size + MAX_REPS>, T>(payload, Size, false, results);
+    runWorkload<ListAdapter<T, Size + MAX_REPS>, T>(payload, Size, true, results);
+    if (Size >= PLACEMENT_MIN_SIZE) // TLB reach matters once the pool is large
+    {
+        runWorkload<ListAdapter<T, Size + MAX_REPS, PagePlacement<HUGE_PAGES_NONE>>, T>(
+            payload, Size, true, results);
+        runWorkload<ListAdapter<T, Size + MAX_REPS, PagePlacement<HUGE_PAGES_EXPLICIT>>, T>(
+            payload, Size, true, results);
+    }
+    // Blocks are at least half full, except after deletes that can not merge
+    runWorkload<UnrolledAdapter<T, (Size + MAX_REPS) / (UNROLLED_BLOCK_SIZE / 2) + 1>, T>(
+        payload, Size, false, results);
+    runWorkload<StdListAdapter<T>, T>(payload, Size, false, results);
+    runWorkload<ForwardListAdapter<T>, T>(payload, Size, false, results);
+    runWorkload<VectorAdapter<T>, T>(payload, Size, false, results);
+}
+
+// Definition of runPayload()
+template <typename T>
+void runPayload(const string &payload, int maxSize, vector<Result> &results)
+{
+    runSize<T, 10>(payload, maxSize, results);
+    runSize<T, 100>(payload, maxSize, results);
+    runSize<T, 1000>(payload, maxSize, results);
+    runSize<T, 10000>(payload, maxSize, results);
+    runSize<T, 100000>(payload, maxSize, results);
+    runSize<T, 1000000>(payload, maxSize, results);
+    runSize<T, 10000000>(payload, maxSize, results);
+}
+
+// Definition of printResults()
+void printResults(const vector<Result> &results, bool json)
+{
+    if (json)
+        cout << "[\n";
+    else
+        cout << "container,payload,size,pool,operation,operations,ns_per_op\n";
+
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const Result &r = results[i];
+        if (json)
+        {
+            cout << "  {\"container\": \"" << r.container << "\", \"payload\": \""
+                 << r.payload << "\", \"size\": " << r.size << ", \"pool\": \""
+                 << r.pool << "\", \"operation\": \"" << r.operation
+                 << "\", \"operations\": " << r.operations
+                 << ", \"ns_per_op\": " << r.nsPerOp
+                 << (i + 1 < results.size() ? "},\n" : "}\n");
+        }
+        else
+        {
+            cout << r.container << ',' << r.payload << ',' << r.size << ','
+                 << r.pool << ',' << r.operation << ',' << r.operations << ','
+                 << r.nsPerOp << '\n';
+        }
+    }
+
+    if (json)
+        cout << "]\n";
+}
@@ -0,0 +1,317 @@
+/*-- replay.cpp ----------------------------------------------------------------
+  Non-interactive trace replay driver for ArrayBasedList<T>.
+
+  Reads a trace file of list operations, using the same vocabulary as the
+  menus of tester.cpp, replays it against an ArrayBasedList at full speed and
+  reports the throughput and the latency percentiles of each operation type.
+
+  Usage:
+    replay <trace file> [repetitions]
+
+  Trace format (one operation per line; blank lines and lines starting with
+  '#' are ignored):
+    insert <position> <value>           Insert at position
+    insertBefore <target> <value>       Insert before value
+    insertAfter <target> <value>        Insert after value
+    forceInsert <position> <value>      Force insert at position
+    forceInsertBefore <target> <value>  Force insert before value
+    forceInsertAfter <target> <value>   Force insert after value
+    delete <position>                   Delete at position
+    deleteBefore <target>               Delete before value
+    deleteValue <value>                 Delete value
+    deleteAfter <target>                Delete after value
+    search <value>                      Search for a value
+    sort                                Sort list
+    size                                Get list size
+
+ * Precondition: The trace file exists and every line follows the format.
+
+ * Postcondition: The whole trace is replayed 'repetitions' times (1 by
+     default), each time on a new empty list, and a report is printed.
+     Returns 0, or 1 if the arguments or the trace are invalid.
+
+  NOTES:
+    The trace is parsed completely before the replay starts, so parsing time
+    is not measured.
+    Build with: g++ -std=c++17 -O2 -o replay replay.cpp
+------------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "ArrayBasedList.h"
+
+typedef int ElementType;
+
+const int REPLAY_CAPACITY = 1000000; // nodes in the replayed list's pool
+
+/** Operation types of a trace, in report order */
+enum TraceOpType
+{
+    OP_INSERT,
+    OP_INSERT_BEFORE,
+    OP_INSERT_AFTER,
+    OP_FORCE_INSERT,
+    OP_FORCE_INSERT_BEFORE,
+    OP_FORCE_INSERT_AFTER,
+    OP_DELETE,
+    OP_DELETE_BEFORE,
+    OP_DELETE_VALUE,
+    OP_DELETE_AFTER,
+    OP_SEARCH,
+    OP_SORT,
+    OP_SIZE,
+    OP_TYPE_COUNT
+};
+
+/** Trace keyword of each operation type, indexed by TraceOpType */
+const char *const TRACE_KEYWORDS[OP_TYPE_COUNT] = {
+    "insert", "insertBefore", "insertAfter",
+    "forceInsert", "forceInsertBefore", "forceInsertAfter",
+    "delete", "deleteBefore", "deleteValue", "deleteAfter",
+    "search", "sort", "size"};
+
+/** One parsed trace line */
+struct TraceOp
+{
+    TraceOpType type;
+    int position;       // position argument (insert, forceInsert, delete)
+    ElementType target; // target argument (before/after operations)
+    ElementType value;  // value argument (insertions, deleteValue, search)
+};
+
+using namespace std;
+
+bool parseTrace(istream &in, vector<TraceOp> &trace);
+/*------------------------------------------------------------------------------
+    Parse a whole trace.
+
+    Precondition:  None.
+    Postcondition: trace holds every operation of the input, in order.
+                   Returns true on success; on a malformed line, prints the
+                   line number to cerr and returns false.
+------------------------------------------------------------------------------*/
+
+bool runOp(ArrayBasedList<ElementType, REPLAY_CAPACITY> &list, const TraceOp &op);
+/*------------------------------------------------------------------------------
+    Apply one trace operation to the list.
+
+    Precondition:  None.
+    Postcondition: The operation is performed; returns its boolean result
+                   (search and size return true when they find/count
+                   something).
+------------------------------------------------------------------------------*/
+
+long long percentile(const vector<long long> &samples, double fraction);
+/*------------------------------------------------------------------------------
+    Get a percentile of a set of latency samples.
+
+    Precondition:  samples is sorted and not empty; 0 <= fraction <= 1.
+    Postcondition: Returns the sample at the given fraction of the set.
+------------------------------------------------------------------------------*/
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2 || argc > 3)
+    {
+        cerr << "Usage: " << argv[0] << " <trace file> [repetitions]\n";
+        return 1;
+    }
+
+    int repetitions = 1; // times the trace is replayed
+    if (argc == 3)
+    {
+        repetitions = atoi(argv[2]);
+        if (repetitions < 1)
+        {
+            cerr << "ERROR: repetitions must be a positive integer.\n";
+            return 1;
+        }
+    }
+
+    ifstream file(argv[1]);
+    if (!file)
+    {
+        cerr << "ERROR: cannot open " << argv[1] << "\n";
+        return 1;
+    }
+
+    vector<TraceOp> trace; // parsed operations
+    if (!parseTrace(file, trace))
+        return 1;
+
+    // Latency samples (nanoseconds) in replay order, in one array sized up
+    // front so that nothing is allocated while operations are timed, and
+    // success counts per operation type
+    vector<long long> timings(trace.size() * repetitions);
+    long long successes[OP_TYPE_COUNT] = {};
+
+    ArrayBasedList<ElementType, REPLAY_CAPACITY> *list =
+        new ArrayBasedList<ElementType, REPLAY_CAPACITY>; // too big for the stack
+
+    chrono::steady_clock::duration total(0); // replay time, all repetitions
+    size_t sample = 0;                       // next sample to record
+    for (int repetition = 0; repetition < repetitions; repetition++)
+    {
+        list->clear();
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+        for (size_t i = 0; i < trace.size(); i++)
+        {
+            // Time the operation alone, not the bookkeeping around it
+            chrono::steady_clock::time_point before = chrono::steady_clock::now();
+            bool result = runOp(*list, trace[i]);
+            chrono::steady_clock::time_point after = chrono::steady_clock::now();
+
+            timings[sample++] =
+                chrono::duration_cast<chrono::nanoseconds>(after - before).count();
+            successes[trace[i].type] += result;
+        }
+        total += chrono::steady_clock::now() - start;
+    }
+    delete list;
+
+    // Group the samples by operation type
+    vector<long long> latencies[OP_TYPE_COUNT];
+    for (size_t i = 0; i < timings.size(); i++)
+        latencies[trace[i % trace.size()].type].push_back(timings[i]);
+
+    // Report
+    double seconds = chrono::duration<double>(total).count();
+    long long operations = (long long)trace.size() * repetitions;
+    cout << "Replayed " << operations << " operations in " << fixed
+         << setprecision(3) << seconds * 1000 << " ms ("
+         << setprecision(0) << (seconds > 0 ? operations / seconds : 0)
+         << " ops/sec)\n\n";
+
+    cout << left << setw(18) << "operation" << right << setw(10) << "count"
+         << setw(10) << "success" << setw(10) << "p50 ns" << setw(10) << "p90 ns"
+         << setw(10) << "p99 ns" << setw(12) << "max ns" << '\n';
+
+    for (int type = 0; type < OP_TYPE_COUNT; type++)
+    {
+        vector<long long> &samples = latencies[type];
+        if (samples.empty()) // operation not in the trace
+            continue;
+
+        sort(samples.begin(), samples.end());
+        cout << left << setw(18) << TRACE_KEYWORDS[type] << right
+             << setw(10) << samples.size() << setw(10) << successes[type]
+             << setw(10) << percentile(samples, 0.50)
+             << setw(10) << percentile(samples, 0.90)
+             << setw(10) << percentile(samples, 0.99)
+             << setw(12) << samples.back() << '\n';
+    }
+    return 0;
+}
+
+// Definition of parseTrace()
+bool parseTrace(istream &in, vector<TraceOp> &trace)
+{
+    string line;
+    int lineNumber = 0;
+    while (getline(in, line))
+    {
+        lineNumber++;
+        istringstream fields(line);
+        string keyword;
+        if (!(fields >> keyword) || keyword[0] == '#') // blank or comment
+            continue;
+
+        TraceOp op = {};
+        int type = 0;
+        while (type < OP_TYPE_COUNT && keyword != TRACE_KEYWORDS[type])
+            type++;
+        op.type = (TraceOpType)type;
+
+        bool valid; // arguments read successfully
+        switch (op.type)
+        {
+        case OP_INSERT:
+        case OP_FORCE_INSERT:
+            valid = (bool)(fields >> op.position >> op.value);
+            break;
+        case OP_INSERT_BEFORE:
+        case OP_INSERT_AFTER:
+        case OP_FORCE_INSERT_BEFORE:
+        case OP_FORCE_INSERT_AFTER:
+            valid = (bool)(fields >> op.target >> op.value);
+            break;
+        case OP_DELETE:
+            valid = (bool)(fields >> op.position);
+            break;
+        case OP_DELETE_BEFORE:
+        case OP_DELETE_AFTER:
+            valid = (bool)(fields >> op.target);
+            break;
+        case OP_DELETE_VALUE:
+        case OP_SEARCH:
+            valid = (bool)(fields >> op.value);
+            break;
+        case OP_SORT:
+        case OP_SIZE:
+            valid = true;
+            break;
+        default: // unknown keyword
+            valid = false;
+        }
+
+        if (!valid)
+        {
+            cerr << "ERROR: invalid trace line " << lineNumber << ": " << line << '\n';
+            return false;
+        }
+        trace.push_back(op);
+    }
+    return true;
+}
+
+// Definition of runOp()
+bool runOp(ArrayBasedList<ElementType, REPLAY_CAPACITY> &list, const TraceOp &op)
+{
+    switch (op.type)
+    {
+    case OP_INSERT:
+        return list.insertAtPosition(op.value, op.position, false);
+    case OP_INSERT_BEFORE:
+        return list.insertBeforeValue(op.value, op.target, false);
+    case OP_INSERT_AFTER:
+        return list.insertAfterValue(op.value, op.target, false);
+    case OP_FORCE_INSERT:
+        return list.insertAtPosition(op.value, op.position, true);
+    case OP_FORCE_INSERT_BEFORE:
+        return list.insertBeforeValue(op.value, op.target, true);
+    case OP_FORCE_INSERT_AFTER:
+        return list.insertAfterValue(op.value, op.target, true);
+    case OP_DELETE:
+        return list.deleteAtPosition(op.position);
+    case OP_DELETE_BEFORE:
+        return list.deleteBeforeValue(op.target);
+    case OP_DELETE_VALUE:
+        return list.deleteValue(op.value);
+    case OP_DELETE_AFTER:
+        return list.deleteAfterValue(op.target);
+    case OP_SEARCH:
+        return list.search(op.value) != NULL_INDEX;
+    case OP_SORT:
+        list.sort();
+        return true;
+    case OP_SIZE:
+        return list.size() > 0;
+    default:
+        return false;
+    }
+}
+
+// Definition of percentile()
+long long percentile(const vector<long long> &samples, double fraction)
+{
+    size_t index = (size_t)(fraction * (samples.size() - 1) + 0.5);
+    return samples[index];
+}
@@ -0,0 +1,61 @@
+// Regression tests of forced inserts and eviction policies.
+// Build: g++ -std=c++17 -I.. -o eviction_test eviction_test.cpp  (from tests/)
+
+#include <cassert>
+#include <iostream>
+#include <vector>
+#include "../ArrayBasedList.h"
+
+using namespace std;
+
+template <typename List>
+vector<int> contents(const List &list)
+{
+    return vector<int>(list.begin(), list.end());
+}
+
+// A forced insert rejected for its position leaves the policy untouched
+void testRejectedInsertKeepsClock()
+{
+    typedef ArrayBasedList<int, 8, NoInstrumentation, EvictClock> List;
+    List rejected, plain;
+    for (int i = 0; i < 8; i++)
+    {
+        rejected.insertAtPosition(i, i);
+        plain.insertAtPosition(i, i);
+    }
+    // Segments hold half the nodes, so the pool is full with 4 elements
+    List::Segment held1 = rejected.splitAt(4);
+    List::Segment held2 = plain.splitAt(4);
+
+    assert(!rejected.insertAtPosition(9, 6, true)); // past the end
+    assert(!rejected.insertAtPosition(9, 4, true)); // end, past it once evicted
+
+    assert(rejected.insertAtPosition(5, 1, true));
+    assert(plain.insertAtPosition(5, 1, true));
+    assert(contents(rejected) == contents(plain));
+    rejected.release(held1);
+    plain.release(held2);
+}
+
+// A range spliced before existing nodes does not become EvictTail's tail
+void testRangeKeepsTail()
+{
+    ArrayBasedList<int, 4, NoInstrumentation, EvictTail> list;
+    list.insertAtPosition(1, 0);
+    list.insertAtPosition(2, 1);
+    vector<int> range = {9, 8};
+    assert(list.insertRange(0, range.begin(), range.end()) == 2);
+    assert(contents(list) == vector<int>({9, 8, 1, 2}));
+
+    assert(list.insertAtPosition(7, 0, true)); // evicts the tail, 2
+    assert(contents(list) == vector<int>({7, 9, 8, 1}));
+}
+
+int main()
+{
+    testRejectedInsertKeepsClock();
+    testRangeKeepsTail();
+    cout << "eviction_test passed\n";
+    return 0;
+}
@@ -0,0 +1,158 @@
+// Crash and replay tests of JournaledList.
+// Build: g++ -std=c++17 -I.. -o journal_test journal_test.cpp  (from tests/)
+
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <memory>
+#include <vector>
+#include <sys/wait.h>
+#include "../JournaledList.h"
+
+using namespace std;
+
+const char *CHECKPOINT = "journal_test.ckpt";
+const char *JOURNAL = "journal_test.wal";
+
+vector<int> contents(const ArrayBasedList<int, 100> &list)
+{
+    return vector<int>(list.begin(), list.end());
+}
+
+void removeFiles()
+{
+    unlink(CHECKPOINT);
+    unlink(JOURNAL);
+}
+
+// A process killed without closing keeps every committed record
+void testCrashReplay()
+{
+    removeFiles();
+    pid_t child = fork();
+    if (child == 0)
+    {
+        JournaledList<int, 100> list;
+        if (!list.open(CHECKPOINT, JOURNAL))
+            _exit(1);
+        for (int i = 0; i < 10; i++)
+            list.insertAtPosition(i, i);
+        list.checkpoint();
+        list.deleteValue(3);
+        list.insertAtPosition(42, 0);
+        _exit(0); // crash: no destructor, no close()
+    }
+    int status;
+    waitpid(child, &status, 0);
+    assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+    JournaledList<int, 100> list;
+    assert(list.open(CHECKPOINT, JOURNAL));
+    assert(contents(list.list()) == vector<int>({42, 0, 1, 2, 4, 5, 6, 7, 8, 9}));
+}
+
+// A torn record at the end of the journal is dropped, and later commits
+// are appended after the last good record
+void testTornTail()
+{
+    removeFiles();
+    {
+        JournaledList<int, 100> list;
+        assert(list.open(CHECKPOINT, JOURNAL));
+        list.insertAtPosition(1, 0);
+        list.insertAtPosition(2, 1);
+    }
+    FILE *journal = fopen(JOURNAL, "ab");
+    fputc(JOURNAL_INSERT_AT_POSITION, journal); // half a record
+    fputc(0, journal);
+    fclose(journal);
+    {
+        JournaledList<int, 100> list;
+        assert(list.open(CHECKPOINT, JOURNAL));
+        assert(contents(list.list()) == vector<int>({1, 2}));
+        list.insertAtPosition(3, 2);
+    }
+    JournaledList<int, 100> list;
+    assert(list.open(CHECKPOINT, JOURNAL));
+    assert(contents(list.list()) == vector<int>({1, 2, 3}));
+}
+
+string readFile(const char *path)
+{
+    ifstream in(path, ios::binary);
+    return string(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+}
+
+void writeFile(const char *path, const string &bytes)
+{
+    ofstream out(path, ios::binary | ios::trunc);
+    out << bytes;
+}
+
+// A crash after the checkpoint rename but before the journal truncate
+// leaves the old journal, which the new checkpoint already holds
+void testCrashAfterRename()
+{
+    removeFiles();
+    string oldJournal;
+    {
+        JournaledList<int, 100> list;
+        assert(list.open(CHECKPOINT, JOURNAL));
+        for (int i = 0; i < 5; i++)
+            list.insertAtPosition(i, 0);
+        assert(list.commit());
+        oldJournal = readFile(JOURNAL);
+        assert(list.checkpoint());
+    }
+    writeFile(JOURNAL, oldJournal); // the truncate never reached the disk
+    {
+        JournaledList<int, 100> list;
+        assert(list.open(CHECKPOINT, JOURNAL));
+        assert(contents(list.list()) == vector<int>({4, 3, 2, 1, 0}));
+        list.insertAtPosition(9, 5); // journaled in the new generation
+    }
+    JournaledList<int, 100> list;
+    assert(list.open(CHECKPOINT, JOURNAL));
+    assert(contents(list.list()) == vector<int>({4, 3, 2, 1, 0, 9}));
+}
+
+// A failed commit keeps the change in memory and reports it in failed()
+void testFailedCommit()
+{
+    unlink(CHECKPOINT);
+    JournaledList<int, 100> list;
+    if (!list.open(CHECKPOINT, "/dev/full")) // every write fails with ENOSPC
+        return;
+    assert(list.insertAtPosition(7, 0)); // applied...
+    assert(list.failed());               // ...but not durable
+    assert(contents(list.list()) == vector<int>({7}));
+    assert(!list.commit());
+    assert(!list.close());
+}
+
+// Opening a large list resets it in place, not through a stack temporary
+void testLargeOpen()
+{
+    removeFiles();
+    unique_ptr<JournaledList<int, 2000000>> list(new JournaledList<int, 2000000>());
+    assert(list->open(CHECKPOINT, JOURNAL));
+    assert(list->insertAtPosition(5, 0));
+    assert(list->close());
+    assert(list->open(CHECKPOINT, JOURNAL));
+    assert(list->list().size() == 1);
+}
+
+int main()
+{
+    testCrashReplay();
+    testTornTail();
+    testCrashAfterRename();
+    testFailedCommit();
+    testLargeOpen();
+    removeFiles();
+    cout << "journal_test passed\n";
+    return 0;
+}
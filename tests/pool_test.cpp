@@ -0,0 +1,92 @@
+// Copy and move tests of lists over a growable NodePool.
+// Build: g++ -std=c++17 -I.. -o pool_test pool_test.cpp  (from tests/)
+
+#include <cassert>
+#include <iostream>
+#include <memory_resource>
+#include <new>
+#include <vector>
+#include "../ArrayBasedList.h"
+
+using namespace std;
+
+typedef ArrayBasedList<int, GROWABLE> List;
+
+vector<int> contents(const List &list)
+{
+    return vector<int>(list.begin(), list.end());
+}
+
+/** Memory resource that fails after a number of allocations */
+class LimitedResource : public pmr::memory_resource
+{
+public:
+    explicit LimitedResource(int allocations) : left(allocations) {}
+
+private:
+    void *do_allocate(size_t bytes, size_t alignment) override
+    {
+        if (left-- <= 0)
+            throw bad_alloc();
+        return pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+    void do_deallocate(void *memory, size_t bytes, size_t alignment) override
+    {
+        pmr::new_delete_resource()->deallocate(memory, bytes, alignment);
+    }
+    bool do_is_equal(const pmr::memory_resource &other) const noexcept override
+    {
+        return this == &other;
+    }
+
+    int left; // allocations still allowed
+};
+
+// A moved-from list is empty and usable
+void testMove()
+{
+    List source;
+    for (int i = 0; i < 3000; i++)
+        source.insertAtPosition(i, i);
+
+    List moved(move(source));
+    assert(moved.size() == 3000);
+    assert(source.isEmpty() && source.size() == 0);
+    assert(source.insertAtPosition(5, 0) && contents(source) == vector<int>({5}));
+
+    List assigned;
+    assigned.insertAtPosition(1, 0);
+    assigned = move(moved);
+    assert(assigned.size() == 3000 && moved.isEmpty());
+}
+
+// A copy that runs out of memory throws and leaves the target as it was
+void testFailedCopy()
+{
+    List source;
+    for (int i = 0; i < 3000; i++)
+        source.insertAtPosition(i, i);
+
+    LimitedResource limited(2); // the directory and one chunk
+    List target(&limited);
+    target.insertAtPosition(7, 0);
+    bool threw = false;
+    try
+    {
+        target = source;
+    }
+    catch (const bad_alloc &)
+    {
+        threw = true;
+    }
+    assert(threw && contents(target) == vector<int>({7}));
+    assert(source.size() == 3000);
+}
+
+int main()
+{
+    testMove();
+    testFailedCopy();
+    cout << "pool_test passed\n";
+    return 0;
+}